@@ -0,0 +1,121 @@
+/*
+ * @Author: HanwGeek
+ * @Github: https://github.com/HanwGeek
+ * @Description: Benchmark of fst_parse against fst_parse_batch on many
+ *               small documents, next to a plain scan of the same bytes
+ * @Date: 2026-10-19 16:40:12
+ * @Last Modified: 2026-10-19 16:40:12
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "../fstjson.h"
+
+#define BENCH_DOCS 100000
+#define BENCH_ROUNDS 5
+
+/* About 100 bytes, the size of a typical RPC body */
+static const char bench_doc[] =
+  "{\"id\":12345,\"method\":\"get\",\"params\":{\"key\":\"user:42\",\"fields\":[\"name\",\"email\"]},\"ok\":true}";
+
+static volatile size_t bench_sink;
+
+static double bench_seconds(clock_t start) {
+  return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+/* Every document must have parsed, and to the same value as fst_parse gives */
+static int bench_check(const fst_value* out, const int* errs, const fst_value* ref) {
+  for (size_t i = 0; i < BENCH_DOCS; i++)
+    if (errs[i] != FST_PARSE_OK || !fst_is_equal(&out[i], ref)) {
+      fprintf(stderr, "document %d: error %d or wrong value\n", (int)i, errs[i]);
+      return 0;
+    }
+  return 1;
+}
+
+static void bench_report(const char* name, double best) {
+  printf("%-24s %8.1f ns/doc\n", name, best * 1e9 / BENCH_DOCS);
+}
+
+int main() {
+  const char** docs = (const char**)malloc(BENCH_DOCS * sizeof(const char*));
+  size_t* lens = (size_t*)malloc(BENCH_DOCS * sizeof(size_t));
+  char* text = (char*)malloc(BENCH_DOCS * sizeof(bench_doc));
+  fst_value* out = (fst_value*)malloc(BENCH_DOCS * sizeof(fst_value));
+  int* errs = (int*)malloc(BENCH_DOCS * sizeof(int));
+  double best[4] = {1e9, 1e9, 1e9, 1e9};
+  fst_value ref;
+
+  /* Separate copies, so that every document comes from its own memory */
+  for (size_t i = 0; i < BENCH_DOCS; i++) {
+    memcpy(text + i * sizeof(bench_doc), bench_doc, sizeof(bench_doc));
+    docs[i] = text + i * sizeof(bench_doc);
+    lens[i] = sizeof(bench_doc) - 1;
+  }
+  fst_init(&ref);
+  if (fst_parse(&ref, bench_doc) != FST_PARSE_OK)
+    return 1;
+
+  for (int r = 0; r < BENCH_ROUNDS; r++) {
+    clock_t start;
+    double t;
+    fst_batch* b;
+
+    /* Lower bound: look at every byte once, as any parser must */
+    start = clock();
+    size_t n = 0;
+    for (size_t i = 0; i < BENCH_DOCS; i++)
+      for (const char* p = docs[i]; *p; p++)
+        n += *p == '"' || *p == '\\' || (unsigned char)*p < 0x20;
+    bench_sink = n;
+    if ((t = bench_seconds(start)) < best[0]) best[0] = t;
+
+    start = clock();
+    for (size_t i = 0; i < BENCH_DOCS; i++) {
+      fst_init(&out[i]);
+      errs[i] = fst_parse(&out[i], docs[i]);
+    }
+    t = bench_seconds(start);
+    if (!bench_check(out, errs, &ref))
+      return 1;
+    start = clock();
+    for (size_t i = 0; i < BENCH_DOCS; i++)
+      fst_free(&out[i]);
+    if ((t += bench_seconds(start)) < best[1]) best[1] = t;
+
+    /* Checked outside the timed region, before the pool goes away */
+    start = clock();
+    b = fst_parse_batch(docs, NULL, BENCH_DOCS, out, errs);
+    t = bench_seconds(start);
+    if (!bench_check(out, errs, &ref))
+      return 1;
+    start = clock();
+    fst_free_batch(b);
+    if ((t += bench_seconds(start)) < best[2]) best[2] = t;
+
+    start = clock();
+    b = fst_parse_batch(docs, lens, BENCH_DOCS, out, errs);
+    t = bench_seconds(start);
+    if (!bench_check(out, errs, &ref))
+      return 1;
+    start = clock();
+    fst_free_batch(b);
+    if ((t += bench_seconds(start)) < best[3]) best[3] = t;
+  }
+
+  printf("%d documents of %d bytes, best of %d rounds\n", BENCH_DOCS, (int)sizeof(bench_doc) - 1, BENCH_ROUNDS);
+  bench_report("byte scan", best[0]);
+  bench_report("fst_parse + fst_free", best[1]);
+  bench_report("fst_parse_batch", best[2]);
+  bench_report("fst_parse_batch (lens)", best[3]);
+
+  fst_free(&ref);
+  free(errs);
+  free(out);
+  free(text);
+  free(lens);
+  free(docs);
+  return 0;
+}
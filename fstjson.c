@@ -5,27 +5,107 @@
  * @Date: 2020-01-01 21:45:56
  * @Last Modified: 2020-01-03 21:31:23
  */
+#ifndef FSTJSON_C_
+#define FSTJSON_C_
+
 #include "fstjson.h"
 #include <assert.h>
+#include <errno.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h> 
+#if !defined(FST_NO_WRITER) && !defined(FST_NO_FD_WRITER)
+#include <sys/uio.h>
+#endif
 
 #ifndef FST_PARSE_STACK_INIT_SIZE
 #define FST_PARSE_STACK_INIT_SIZE 256
 #endif
 
-#define EXPECT(c, ch) do {assert(*c->json == (ch)); c->json++;} while(0)
-#define ISDIGIT(ch) ((ch) >= '0' && (ch) <= '9')
-#define ISDIGIT1TO9(ch) ((ch) >= '1' && (ch) <= '9')
-#define PUTC(c, ch) do {*(char*)fst_context_push(c, sizeof(char)) = (ch);} while(0)
-#define STRING_ERR(ret) do {c->top = head; return ret;} while(0)
+#ifndef FST_STRINGIFY_BUFFER_SIZE
+#define FST_STRINGIFY_BUFFER_SIZE 256
+#endif
+
+#ifndef FST_CONTAINER_INIT_SIZE
+#define FST_CONTAINER_INIT_SIZE 4
+#endif
+
+#ifndef FST_BATCH_INIT_SIZE
+#define FST_BATCH_INIT_SIZE 4096
+#endif
+
+#ifndef FST_BATCH_PREFETCH_SIZE
+#define FST_BATCH_PREFETCH_SIZE 256
+#endif
+
+#ifndef FST_CACHE_LINE_SIZE
+#define FST_CACHE_LINE_SIZE 64
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define FST_PREFETCH(p) __builtin_prefetch(p)
+#else
+#define FST_PREFETCH(p) ((void)(p))
+#endif
+
+#define FST_EXPECT(c, ch) do {assert(*c->json == (ch)); c->json++;} while(0)
+#define FST_ISDIGIT(ch) ((ch) >= '0' && (ch) <= '9')
+#define FST_ISDIGIT1TO9(ch) ((ch) >= '1' && (ch) <= '9')
+#define FST_PUTC(c, ch) do {*(char*)fst_context_push(c, sizeof(char)) = (ch);} while(0)
+#define FST_STRING_ERR(ret, pos) do {c->top = head; c->json = (pos); return ret;} while(0)
+
+/* One chunk of a batch pool, chunks are chained newest first */
+struct fst_batch {
+  fst_batch* next;
+  size_t size, top;
+};
+
+/* Chunk payload starts past the header, aligned for double */
+#define FST_BATCH_HEADER ((sizeof(fst_batch) + sizeof(double) - 1) & ~(sizeof(double) - 1))
 
 typedef struct {
   const char* json;
   char* stack;
   size_t size, top;
+  fst_batch* pool; /* NULL: nodes are malloc'd one by one */
 }fst_context;
 
+/* Bump-allocate `size` bytes from the pool, chaining a larger chunk when full */
+static void* fst_batch_alloc(fst_batch** pool, size_t size) {
+  fst_batch* b = *pool;
+  size = (size + sizeof(double) - 1) & ~(sizeof(double) - 1);
+  if (b->top + size > b->size) {
+    size_t n = b->size * 2;
+    while (n < size) n *= 2;
+    fst_batch* nb = (fst_batch*)malloc(FST_BATCH_HEADER + n);
+    nb->next = b;
+    nb->size = n;
+    nb->top = 0;
+    *pool = b = nb;
+  }
+  void* ret = (char*)b + FST_BATCH_HEADER + b->top;
+  b->top += size;
+  return ret;
+}
+
+static void* fst_context_alloc(fst_context* c, size_t size) {
+  return c->pool != NULL ? fst_batch_alloc(&c->pool, size) : malloc(size);
+}
+
+/* Pool memory is reclaimed by rewinding the pool, not node by node */
+static void fst_context_free(fst_context* c, void* p) {
+  if (c->pool == NULL)
+    free(p);
+}
+
+static void fst_context_free_value(fst_context* c, fst_value* v) {
+  if (c->pool == NULL)
+    fst_free(v);
+  v->type = FST_NULL;
+}
+
 /* Allocate `size` memory to stack, return top of stack */
 static void* fst_context_push(fst_context* c, size_t size) {
   assert(size > 0);
@@ -61,35 +141,42 @@ static void fst_parse_whitespace(fst_context* c) {
    false == "false" */
 static int fst_parse_literal(fst_context* c, fst_value* v, const char* literal, fst_type type) {
   size_t i;
-  EXPECT(c, literal[0]);
+  FST_EXPECT(c, literal[0]);
   for (i = 0; literal[i + 1]; i++)
-    if (c->json[i] != literal[i + 1]) 
+    if (c->json[i] != literal[i + 1]) {
+      c->json += i;
       return FST_PARSE_INVALID_VALUE;
+    }
   c->json += i;
   v->type = type;
   return FST_PARSE_OK;
 }
 
+#define FST_NUMBER_ERR() do {c->json = p; return FST_PARSE_INVALID_VALUE;} while(0)
+
 static int fst_parse_number(fst_context* c, fst_value* v) {
   const char* p = c->json;
   if (*p == '-') p++;
   if (*p == '0') p++;
   else {
-    if (!ISDIGIT1TO9(*p)) return FST_PARSE_INVALID_VALUE;
-    for (p++; ISDIGIT(*p); p++);
+    if (!FST_ISDIGIT1TO9(*p)) FST_NUMBER_ERR();
+    for (p++; FST_ISDIGIT(*p); p++);
   }
   if (*p == '.') {
     p++;
-    if(!ISDIGIT(*p)) return FST_PARSE_INVALID_VALUE;
-    for (p++; ISDIGIT(*p); p++);
+    if(!FST_ISDIGIT(*p)) FST_NUMBER_ERR();
+    for (p++; FST_ISDIGIT(*p); p++);
   }
   if (*p == 'e' || *p == 'E') {
     p++;
     if (*p == '+' || *p == '-') p++;
-    if (!ISDIGIT(*p)) return FST_PARSE_INVALID_VALUE;
-    for (p++; ISDIGIT(*p); p++);
+    if (!FST_ISDIGIT(*p)) FST_NUMBER_ERR();
+    for (p++; FST_ISDIGIT(*p); p++);
   }
+  errno = 0;
   v->u.n = strtod(c->json, NULL);
+  if (errno == ERANGE && (v->u.n == HUGE_VAL || v->u.n == -HUGE_VAL))
+    return FST_PARSE_NUMBER_TOO_BIG;
   c->json = p;
   v->type = FST_NUMBER;
   return FST_PARSE_OK;
@@ -110,32 +197,46 @@ static const char* fst_parse_hex4(const char* p, unsigned* u) {
 
 static void fst_encode_utf8(fst_context* c, unsigned u) {
   if (u <= 0x7F) 
-    PUTC(c, u & 0xFF);
+    FST_PUTC(c, u & 0xFF);
   else if (u <= 0x7FF) {
-    PUTC(c, 0xC0 | ((u >> 6) & 0xFF));
-    PUTC(c, 0x80 | ( u       & 0x3F));
+    FST_PUTC(c, 0xC0 | ((u >> 6) & 0xFF));
+    FST_PUTC(c, 0x80 | ( u       & 0x3F));
   }
   else if (u <= 0xFFFF) {
-    PUTC(c, 0xE0 | ((u >> 12) & 0xFF));
-    PUTC(c, 0x80 | ((u >>  6) & 0x3F));
-    PUTC(c, 0x80 | ( u        & 0x3F));
+    FST_PUTC(c, 0xE0 | ((u >> 12) & 0xFF));
+    FST_PUTC(c, 0x80 | ((u >>  6) & 0x3F));
+    FST_PUTC(c, 0x80 | ( u        & 0x3F));
   }
   else {
     assert(u <= 0x10FFFF);
-    PUTC(c, 0xF0 | ((u >> 18) & 0xFF));
-    PUTC(c, 0x80 | ((u >> 12) & 0x3F));
-    PUTC(c, 0x80 | ((u >>  6) & 0x3F));
-    PUTC(c, 0x80 | ( u        & 0x3F));
+    FST_PUTC(c, 0xF0 | ((u >> 18) & 0xFF));
+    FST_PUTC(c, 0x80 | ((u >> 12) & 0x3F));
+    FST_PUTC(c, 0x80 | ((u >>  6) & 0x3F));
+    FST_PUTC(c, 0x80 | ( u        & 0x3F));
   }  
 }
 
-static int fst_parse_string_raw(fst_context* c, char** str, size_t* len) {
+/* Unescaped strings come back pointing into the input, not NUL-terminated;
+   the stack only holds strings that contain escapes */
+static int fst_parse_string_raw(fst_context* c, const char** str, size_t* len) {
   size_t head = c->top;
-  EXPECT(c, '\"');  
+  FST_EXPECT(c, '\"');  
   const char* p = c->json;
+  const char* q; /* start of the current run, then of the current escape */
   unsigned u, u2;
   for (;;) {
+    q = p;
+    while ((unsigned char)*p >= 0x20 && *p != '\"' && *p != '\\')
+      p++;
     char ch = *p++;
+    if (ch == '\"' && c->top == head) {
+      *str = q;
+      *len = p - 1 - q;
+      c->json = p;
+      return FST_PARSE_OK;
+    }
+    if (p - 1 > q)
+      memcpy(fst_context_push(c, p - 1 - q), q, p - 1 - q);
     switch (ch) {
       case '\"': 
         *len = c->top - head;
@@ -143,49 +244,56 @@ static int fst_parse_string_raw(fst_context* c, char** str, size_t* len) {
         c->json = p;
         return FST_PARSE_OK;
       case '\\': 
+        q = p - 1;
         switch (*p++) {
-          case '\"': PUTC(c, '\"'); break;
-          case '\\': PUTC(c, '\\'); break;
-          case '/':  PUTC(c, '/' ); break;
-          case 'b':  PUTC(c, '\b'); break;
-          case 'f':  PUTC(c, '\f'); break;
-          case 'n':  PUTC(c, '\n'); break;
-          case 'r':  PUTC(c, '\r'); break;
-          case 't':  PUTC(c, '\t'); break;
+          case '\"': FST_PUTC(c, '\"'); break;
+          case '\\': FST_PUTC(c, '\\'); break;
+          case '/':  FST_PUTC(c, '/' ); break;
+          case 'b':  FST_PUTC(c, '\b'); break;
+          case 'f':  FST_PUTC(c, '\f'); break;
+          case 'n':  FST_PUTC(c, '\n'); break;
+          case 'r':  FST_PUTC(c, '\r'); break;
+          case 't':  FST_PUTC(c, '\t'); break;
           case 'u':  
             if (!(p = fst_parse_hex4(p, &u)))
-              STRING_ERR(FST_PARSE_INVALID_UNICODE_HEX);
+              FST_STRING_ERR(FST_PARSE_INVALID_UNICODE_HEX, q);
             if (u >= 0xD800 && u <= 0xDBFF) {
               if (*p++ != '\\')
-                STRING_ERR(FST_PARSE_INVALID_UNICODE_SURROGATE);
+                FST_STRING_ERR(FST_PARSE_INVALID_UNICODE_SURROGATE, q);
               if (*p++ != 'u')
-                STRING_ERR(FST_PARSE_INVALID_UNICODE_SURROGATE);
-              if (!(p = fst_parse_hex4(p, &u2)));
-                STRING_ERR(FST_PARSE_INVALID_UNICODE_HEX);
+                FST_STRING_ERR(FST_PARSE_INVALID_UNICODE_SURROGATE, q);
+              if (!(p = fst_parse_hex4(p, &u2)))
+                FST_STRING_ERR(FST_PARSE_INVALID_UNICODE_HEX, q);
               if (u2 < 0xDC00 || u2 > 0xDFFF)
-                STRING_ERR(FST_PARSE_INVALID_UNICODE_SURROGATE);
+                FST_STRING_ERR(FST_PARSE_INVALID_UNICODE_SURROGATE, q);
               u = (((u - 0xD800) << 10) | (u2 - 0xDC00)) + 0x10000;
             }
             fst_encode_utf8(c, u);
             break;           
           default:
-            STRING_ERR(FST_PARSE_INVALID_STRING_ESCAPE);
+            FST_STRING_ERR(FST_PARSE_INVALID_STRING_ESCAPE, q);
         } break;
       case '\0': 
-        STRING_ERR(FST_PARSE_MISS_QUOTATION_MARK);
-      default: if ((unsigned char)ch < 0x20) 
-                  STRING_ERR(FST_PARSE_INVALID_STRING_CHAR);            
-                PUTC(c, ch);
+        FST_STRING_ERR(FST_PARSE_MISS_QUOTATION_MARK, p - 1);
+      default:
+        FST_STRING_ERR(FST_PARSE_INVALID_STRING_CHAR, p - 1);
     }
   }  
 }
 
 static int fst_parse_string(fst_context* c, fst_value* v) {
   int ret;
-  char* s;
+  const char* s;
   size_t len;
-  if ((ret = fst_parse_string_raw(c, &s, &len)) == FST_PARSE_OK)
-    fst_set_string(v, s, len);
+  if ((ret = fst_parse_string_raw(c, &s, &len)) == FST_PARSE_OK) {
+    v->u.s.s = (char*)fst_context_alloc(c, len + 1);
+    if (len > 0)
+      memcpy(v->u.s.s, s, len);
+    v->u.s.s[len] = '\0';
+    v->u.s.len = len;
+    v->type = FST_STRING;
+    v->pooled = c->pool != NULL;
+  }
   return ret;
 }
 
@@ -193,12 +301,13 @@ static int fst_parse_value(fst_context* c, fst_value* v);
 static int fst_parse_array(fst_context* c, fst_value* v) {
   size_t size = 0;
   int ret;
-  EXPECT(c, '[');
+  FST_EXPECT(c, '[');
   fst_parse_whitespace(c);
   if (*c->json == ']') {
     c->json++;
     v->type = FST_ARRAY;
-    v->u.a.size = 0;
+    v->pooled = 0;
+    v->u.a.size = v->u.a.capacity = 0;
     v->u.a.e = NULL;
     return FST_PARSE_OK;
   }
@@ -216,9 +325,10 @@ static int fst_parse_array(fst_context* c, fst_value* v) {
     } else if (*c->json == ']') {
       c->json++;
       v->type = FST_ARRAY;
-      v->u.a.size = size;
+      v->pooled = c->pool != NULL;
+      v->u.a.size = v->u.a.capacity = size;
       size *= sizeof(fst_value);
-      memcpy(v->u.a.e = (fst_value*)malloc(size), fst_context_pop(c, size), size);
+      memcpy(v->u.a.e = (fst_value*)fst_context_alloc(c, size), fst_context_pop(c, size), size);
       return FST_PARSE_OK;
     } else {
       ret = FST_PARSE_MISS_COMMA_OR_SQUARE_BRACKET;
@@ -226,12 +336,12 @@ static int fst_parse_array(fst_context* c, fst_value* v) {
     }
   }
   for (size_t i = 0; i < size; i++)
-    fst_free((fst_value*)fst_context_pop(c, sizeof(fst_value)));
+    fst_context_free_value(c, (fst_value*)fst_context_pop(c, sizeof(fst_value)));
   return ret;
 }
 
 static int fst_parse_object(fst_context* c, fst_value* v) {
-  EXPECT(c, '{');
+  FST_EXPECT(c, '{');
   fst_member m;
   size_t size;
   int ret;
@@ -239,8 +349,9 @@ static int fst_parse_object(fst_context* c, fst_value* v) {
   if (*c->json == '}') {
     c->json++;
     v->type = FST_OBJ;
+    v->pooled = 0;
     v->u.o.m = NULL;
-    v->u.o.size = 0;
+    v->u.o.size = v->u.o.capacity = 0;
     return FST_PARSE_OK;
   }
 
@@ -252,10 +363,12 @@ static int fst_parse_object(fst_context* c, fst_value* v) {
       ret = FST_PARSE_MISS_KEY;
       break;
     }
-    char* str;
+    const char* str;
     if ((ret = fst_parse_string_raw(c, &str, &m.klen)) != FST_PARSE_OK)
       break;
-    memcpy(m.k = (char*)malloc(m.klen + 1), str, m.klen);
+    m.k = (char*)fst_context_alloc(c, m.klen + 1);
+    if (m.klen > 0)
+      memcpy(m.k, str, m.klen);
     m.k[m.klen] = '\0';
 
     fst_parse_whitespace(c);
@@ -279,21 +392,22 @@ static int fst_parse_object(fst_context* c, fst_value* v) {
       fst_parse_whitespace(c);
     } else if (*c->json == '}') {
       c->json++;
-      v->u.o.size = size;
+      v->u.o.size = v->u.o.capacity = size;
       size_t s = sizeof(fst_member) * size;
-      memcpy(v->u.o.m = (fst_member*)malloc(s), fst_context_pop(c, s), s);
+      memcpy(v->u.o.m = (fst_member*)fst_context_alloc(c, s), fst_context_pop(c, s), s);
       v->type = FST_OBJ;
+      v->pooled = c->pool != NULL;
       return FST_PARSE_OK;
     } else {
       ret = FST_PARSE_MISS_COMMA_OR_CURLY_BRACKET;
       break;
     }
   }
-  free(m.k);
+  fst_context_free(c, m.k);
   for (size_t i = 0; i < size; i++) {
     fst_member* m = (fst_member*)fst_context_pop(c, sizeof(fst_member));
-    free(m->k);
-    fst_free(&m->v);
+    fst_context_free(c, m->k);
+    fst_context_free_value(c, &m->v);
   }
   v->type = FST_NULL;
   return ret;
@@ -312,101 +426,799 @@ static int fst_parse_value(fst_context* c, fst_value* v) {
   }
 }
 
-void fst_free(fst_value* v) {
+/* Pooled storage is left to fst_free_batch, children may still own memory */
+FST_API void fst_free(fst_value* v) {
   assert(v != NULL);
   switch (v->type) {
-    case FST_STRING: free(v->u.s.s); break;
+    case FST_STRING:
+      if (!v->pooled)
+        free(v->u.s.s);
+      break;
     case FST_ARRAY:
       for (size_t i = 0; i < v->u.a.size; i++)
         fst_free(&v->u.a.e[i]);
-      free(v->u.a.e);
+      if (!v->pooled)
+        free(v->u.a.e);
       break;
     case FST_OBJ:
       for (size_t i = 0; i < v->u.o.size; i++) {
-        free(v->u.o.m[i].k);
+        if (!v->pooled)
+          free(v->u.o.m[i].k);
         fst_free(&v->u.o.m[i].v);
       }
-      free(v->u.o.m);
+      if (!v->pooled)
+        free(v->u.o.m);
       break;
     default: break;
   }
   v->type = FST_NULL;
 }
 
-int fst_get_boolean(const fst_value* v) {
+/* Deep copy `src` into `dst` */
+FST_API void fst_copy(fst_value* dst, const fst_value* src) {
+  assert(dst != NULL && src != NULL && dst != src);
+  switch (src->type) {
+    case FST_STRING:
+      fst_set_string(dst, src->u.s.s, src->u.s.len);
+      break;
+    case FST_ARRAY:
+      fst_set_array(dst, src->u.a.size);
+      for (size_t i = 0; i < src->u.a.size; i++)
+        fst_copy(fst_pushback_array_elem(dst), &src->u.a.e[i]);
+      break;
+    case FST_OBJ:
+      fst_set_object(dst, src->u.o.size);
+      for (size_t i = 0; i < src->u.o.size; i++) {
+        fst_member* m = &dst->u.o.m[dst->u.o.size++];
+        memcpy(m->k = (char*)malloc(src->u.o.m[i].klen + 1), src->u.o.m[i].k, src->u.o.m[i].klen + 1);
+        m->klen = src->u.o.m[i].klen;
+        fst_init(&m->v);
+        fst_copy(&m->v, &src->u.o.m[i].v);
+      }
+      break;
+    default:
+      fst_free(dst);
+      memcpy(dst, src, sizeof(fst_value));
+      dst->pooled = 0;
+      break;
+  }
+}
+
+/* Objects are equal when they hold the same members in the same order,
+   or the same unique keys in any order */
+FST_API int fst_is_equal(const fst_value* lhs, const fst_value* rhs) {
+  assert(lhs != NULL && rhs != NULL);
+  if (lhs->type != rhs->type)
+    return 0;
+  switch (lhs->type) {
+    case FST_STRING:
+      return lhs->u.s.len == rhs->u.s.len &&
+        memcmp(lhs->u.s.s, rhs->u.s.s, lhs->u.s.len) == 0;
+    case FST_NUMBER:
+      return lhs->u.n == rhs->u.n;
+    case FST_ARRAY:
+      if (lhs->u.a.size != rhs->u.a.size)
+        return 0;
+      for (size_t i = 0; i < lhs->u.a.size; i++)
+        if (!fst_is_equal(&lhs->u.a.e[i], &rhs->u.a.e[i]))
+          return 0;
+      return 1;
+    case FST_OBJ:
+      if (lhs->u.o.size != rhs->u.o.size)
+        return 0;
+      size_t i;
+      for (i = 0; i < lhs->u.o.size; i++) {
+        const fst_member* l = &lhs->u.o.m[i];
+        const fst_member* r = &rhs->u.o.m[i];
+        if (l->klen != r->klen || memcmp(l->k, r->k, l->klen) != 0 || !fst_is_equal(&l->v, &r->v))
+          break;
+      }
+      if (i == lhs->u.o.size)
+        return 1;
+      /* Out of order, duplicate keys would make the lookup one-sided */
+      for (i = 0; i < lhs->u.o.size; i++) {
+        const fst_member* l = &lhs->u.o.m[i];
+        const fst_member* r = &rhs->u.o.m[i];
+        if (fst_find_object_index(lhs, l->k, l->klen) != i || fst_find_object_index(rhs, r->k, r->klen) != i)
+          return 0;
+        fst_value* v = fst_find_object_value(rhs, l->k, l->klen);
+        if (v == NULL || !fst_is_equal(&l->v, v))
+          return 0;
+      }
+      return 1;
+    default:
+      return 1;
+  }
+}
+
+FST_API int fst_get_boolean(const fst_value* v) {
   assert(v != NULL && (v->type == FST_TRUE || v->type == FST_FALSE));
   return v->type == FST_TRUE;
 }
 
-void fst_set_boolean(fst_value* v, int b) {
+FST_API void fst_set_boolean(fst_value* v, int b) {
   fst_free(v);
   v->type = b ? FST_TRUE : FST_FALSE;
 }
 
-double fst_get_number(const fst_value* v) {
+FST_API double fst_get_number(const fst_value* v) {
   assert(v != NULL && v->type == FST_NUMBER);
   return v->u.n;
 }
 
-void fst_set_number(fst_value* v, double n) {
+FST_API void fst_set_number(fst_value* v, double n) {
   fst_free(v);
   v->type = FST_NUMBER;
   v->u.n = n;
 }
 
-const char* fst_get_string(const fst_value* v) {
+FST_API const char* fst_get_string(const fst_value* v) {
   assert(v != NULL && v->type == FST_STRING);
   return v->u.s.s;
 }
 
-size_t fst_get_string_len(const fst_value* v) {
+FST_API size_t fst_get_string_len(const fst_value* v) {
   assert(v != NULL && v->type == FST_STRING);
   return v->u.s.len;
 }
 
-void fst_set_string(fst_value* v, const char* s, size_t len) {
+FST_API void fst_set_string(fst_value* v, const char* s, size_t len) {
   assert(v != NULL && (s != NULL || len == 0));
   fst_free(v);
   v->u.s.s = (char*)malloc(len + 1);
   v->u.s.s[len] = '\0';
-  memcpy(v->u.s.s, s, len);
+  if (len > 0)
+    memcpy(v->u.s.s, s, len);
   v->u.s.len = len;
   v->type = FST_STRING;
+  v->pooled = 0;
+}
+
+/* Next capacity after `capacity`, grown by 1.5x like the parse stack */
+static size_t fst_grow_capacity(size_t capacity) {
+  return capacity < FST_CONTAINER_INIT_SIZE ? FST_CONTAINER_INIT_SIZE : capacity + (capacity >> 1);
+}
+
+FST_API void fst_set_array(fst_value* v, size_t capacity) {
+  assert(v != NULL);
+  fst_free(v);
+  v->type = FST_ARRAY;
+  v->pooled = 0;
+  v->u.a.size = 0;
+  v->u.a.capacity = capacity;
+  v->u.a.e = capacity > 0 ? (fst_value*)malloc(capacity * sizeof(fst_value)) : NULL;
 }
 
-size_t fst_get_array_size(const fst_value* v) {
+FST_API size_t fst_get_array_size(const fst_value* v) {
   assert (v != NULL && v->type == FST_ARRAY);
   return v->u.a.size;
 }
 
-fst_value* fst_get_array_elem(const fst_value* v, size_t index) {
+FST_API size_t fst_get_array_capacity(const fst_value* v) {
+  assert (v != NULL && v->type == FST_ARRAY);
+  return v->u.a.capacity;
+}
+
+FST_API fst_value* fst_get_array_elem(const fst_value* v, size_t index) {
   assert(v != NULL && v->type == FST_ARRAY);
   assert(index < v->u.a.size);
   return &v->u.a.e[index];
 }
 
-int fst_parse(fst_value* v, const char* json) {
+/* Append a null elem, return it */
+FST_API fst_value* fst_pushback_array_elem(fst_value* v) {
+  assert(v != NULL && v->type == FST_ARRAY);
+  if (v->u.a.size == v->u.a.capacity || v->pooled)
+    fst_reserve(v, fst_grow_capacity(v->u.a.capacity));
+  fst_value* e = &v->u.a.e[v->u.a.size++];
+  fst_init(e);
+  return e;
+}
+
+/* Insert a null elem before `index`, return it */
+FST_API fst_value* fst_insert_array_elem(fst_value* v, size_t index) {
+  assert(v != NULL && v->type == FST_ARRAY && index <= v->u.a.size);
+  if (v->u.a.size == v->u.a.capacity || v->pooled)
+    fst_reserve(v, fst_grow_capacity(v->u.a.capacity));
+  memmove(&v->u.a.e[index + 1], &v->u.a.e[index], (v->u.a.size - index) * sizeof(fst_value));
+  v->u.a.size++;
+  fst_init(&v->u.a.e[index]);
+  return &v->u.a.e[index];
+}
+
+FST_API void fst_set_object(fst_value* v, size_t capacity) {
+  assert(v != NULL);
+  fst_free(v);
+  v->type = FST_OBJ;
+  v->pooled = 0;
+  v->u.o.size = 0;
+  v->u.o.capacity = capacity;
+  v->u.o.m = capacity > 0 ? (fst_member*)malloc(capacity * sizeof(fst_member)) : NULL;
+}
+
+FST_API size_t fst_get_object_size(const fst_value* v) {
+  assert(v != NULL && v->type == FST_OBJ);
+  return v->u.o.size;
+}
+
+FST_API size_t fst_get_object_capacity(const fst_value* v) {
+  assert(v != NULL && v->type == FST_OBJ);
+  return v->u.o.capacity;
+}
+
+FST_API const char* fst_get_object_key(const fst_value* v, size_t index) {
+  assert(v != NULL && v->type == FST_OBJ);
+  assert(index < v->u.o.size);
+  return v->u.o.m[index].k;
+}
+
+FST_API size_t fst_get_object_key_length(const fst_value* v, size_t index) {
+  assert(v != NULL && v->type == FST_OBJ);
+  assert(index < v->u.o.size);
+  return v->u.o.m[index].klen;
+}
+
+FST_API fst_value* fst_get_object_value(const fst_value* v, size_t index) {
+  assert(v != NULL && v->type == FST_OBJ);
+  assert(index < v->u.o.size);
+  return &v->u.o.m[index].v;
+}
+
+/* Return index of the first member with `key`, or FST_KEY_NOT_EXIST */
+FST_API size_t fst_find_object_index(const fst_value* v, const char* key, size_t klen) {
+  assert(v != NULL && v->type == FST_OBJ && key != NULL);
+  for (size_t i = 0; i < v->u.o.size; i++)
+    if (v->u.o.m[i].klen == klen && memcmp(v->u.o.m[i].k, key, klen) == 0)
+      return i;
+  return FST_KEY_NOT_EXIST;
+}
+
+FST_API fst_value* fst_find_object_value(const fst_value* v, const char* key, size_t klen) {
+  size_t index = fst_find_object_index(v, key, klen);
+  return index != FST_KEY_NOT_EXIST ? &v->u.o.m[index].v : NULL;
+}
+
+/* Return value of member `key`, appending a null member if it does not exist */
+FST_API fst_value* fst_set_object_value(fst_value* v, const char* key, size_t klen) {
+  fst_value* ret;
+  if ((ret = fst_find_object_value(v, key, klen)) != NULL)
+    return ret;
+  if (v->u.o.size == v->u.o.capacity || v->pooled)
+    fst_reserve(v, fst_grow_capacity(v->u.o.capacity));
+  fst_member* m = &v->u.o.m[v->u.o.size++];
+  memcpy(m->k = (char*)malloc(klen + 1), key, klen);
+  m->k[klen] = '\0';
+  m->klen = klen;
+  fst_init(&m->v);
+  return &m->v;
+}
+
+FST_API void fst_remove_object_value(fst_value* v, size_t index) {
+  assert(v != NULL && v->type == FST_OBJ && index < v->u.o.size);
+  if (v->pooled)
+    fst_reserve(v, v->u.o.capacity);
+  free(v->u.o.m[index].k);
+  fst_free(&v->u.o.m[index].v);
+  memmove(&v->u.o.m[index], &v->u.o.m[index + 1], (v->u.o.size - index - 1) * sizeof(fst_member));
+  v->u.o.size--;
+}
+
+/* Move pooled container storage, and the keys of an object, to malloc'd
+   storage of `capacity` so that it can be grown and freed like any other */
+static void fst_unpool(fst_value* v, size_t capacity) {
+  assert(v->pooled);
+  if (v->type == FST_ARRAY) {
+    fst_value* e = capacity > 0 ? (fst_value*)malloc(capacity * sizeof(fst_value)) : NULL;
+    if (v->u.a.size > 0)
+      memcpy(e, v->u.a.e, v->u.a.size * sizeof(fst_value));
+    v->u.a.e = e;
+    v->u.a.capacity = capacity;
+  } else {
+    fst_member* m = capacity > 0 ? (fst_member*)malloc(capacity * sizeof(fst_member)) : NULL;
+    for (size_t i = 0; i < v->u.o.size; i++) {
+      m[i] = v->u.o.m[i];
+      memcpy(m[i].k = (char*)malloc(m[i].klen + 1), v->u.o.m[i].k, m[i].klen + 1);
+    }
+    v->u.o.m = m;
+    v->u.o.capacity = capacity;
+  }
+  v->pooled = 0;
+}
+
+FST_API void fst_reserve(fst_value* v, size_t capacity) {
+  assert(v != NULL && (v->type == FST_ARRAY || v->type == FST_OBJ));
+  if (v->pooled) {
+    size_t old = v->type == FST_ARRAY ? v->u.a.capacity : v->u.o.capacity;
+    fst_unpool(v, capacity > old ? capacity : old);
+    return;
+  }
+  if (v->type == FST_ARRAY) {
+    if (v->u.a.capacity < capacity) {
+      v->u.a.capacity = capacity;
+      v->u.a.e = (fst_value*)realloc(v->u.a.e, capacity * sizeof(fst_value));
+    }
+  } else {
+    if (v->u.o.capacity < capacity) {
+      v->u.o.capacity = capacity;
+      v->u.o.m = (fst_member*)realloc(v->u.o.m, capacity * sizeof(fst_member));
+    }
+  }
+}
+
+/* Release unused capacity */
+FST_API void fst_shrink(fst_value* v) {
+  assert(v != NULL && (v->type == FST_ARRAY || v->type == FST_OBJ));
+  if (v->pooled) {
+    fst_unpool(v, v->type == FST_ARRAY ? v->u.a.size : v->u.o.size);
+    return;
+  }
+  if (v->type == FST_ARRAY) {
+    if (v->u.a.capacity > v->u.a.size) {
+      v->u.a.capacity = v->u.a.size;
+      if (v->u.a.size == 0) {
+        free(v->u.a.e);
+        v->u.a.e = NULL;
+      } else
+        v->u.a.e = (fst_value*)realloc(v->u.a.e, v->u.a.size * sizeof(fst_value));
+    }
+  } else {
+    if (v->u.o.capacity > v->u.o.size) {
+      v->u.o.capacity = v->u.o.size;
+      if (v->u.o.size == 0) {
+        free(v->u.o.m);
+        v->u.o.m = NULL;
+      } else
+        v->u.o.m = (fst_member*)realloc(v->u.o.m, v->u.o.size * sizeof(fst_member));
+    }
+  }
+}
+
+FST_API int fst_parse(fst_value* v, const char* json) {
+  return fst_parse_ex(v, json, NULL);
+}
+
+/* Parse one document from `c->json`, the stack is left for reuse */
+static int fst_parse_root(fst_context* c, fst_value* v) {
+  v->type = FST_NULL;
+  fst_parse_whitespace(c);
+  int ret =  fst_parse_value(c, v);
+  if (ret == FST_PARSE_OK) {
+    fst_parse_whitespace(c);
+    if (*c->json != '\0') {
+      fst_context_free_value(c, v);
+      ret = FST_PARSE_ROOT_NOT_SINGULAR;
+    }
+  }
+  assert(c->top == 0);
+  return ret;
+}
+
+/* Parse as fst_parse, also report where parsing stopped in `r` */
+FST_API int fst_parse_ex(fst_value* v, const char* json, fst_parse_result* r) {
   fst_context c;
   assert(v != NULL);
   c.json = json;
   c.stack = NULL;
   c.size = c.top = 0;
-  v->type = FST_NULL;
-  fst_parse_whitespace(&c);
-  int ret =  fst_parse_value(&c, v);
-  if (ret == FST_PARSE_OK) {
-    fst_parse_whitespace(&c);
-    if (*c.json != '\0') {
-      v->type = FST_NULL;
+  c.pool = NULL;
+  int ret = fst_parse_root(&c, v);
+  free(c.stack);
+  if (r != NULL) {
+    r->code = ret;
+    r->offset = (size_t)(c.json - json);
+    r->line = r->column = 0;
+  }
+  return ret;
+}
+
+/* Parse `n` documents into `out`, sharing one context and stack. Every
+   node goes to a single pool, released at once by fst_free_batch. With
+   `lens`, documents need not be NUL-terminated: each is copied into a
+   shared scratch buffer, which also checks for an embedded NUL */
+FST_API fst_batch* fst_parse_batch(const char* const* docs, const size_t* lens, size_t n, fst_value* out, int* errs) {
+  fst_context c;
+  char* scratch = NULL;
+  size_t cap = 0, total = 0, init = FST_BATCH_INIT_SIZE;
+  assert(docs != NULL && out != NULL);
+  /* A DOM takes a few times the text, try to fit the whole batch in one chunk */
+  if (lens != NULL)
+    for (size_t i = 0; i < n; i++)
+      total += lens[i];
+  while (init < total * 4)
+    init *= 2;
+  c.pool = (fst_batch*)malloc(FST_BATCH_HEADER + init);
+  c.pool->next = NULL;
+  c.pool->size = init;
+  c.pool->top = 0;
+  c.stack = (char*)malloc(c.size = FST_PARSE_STACK_INIT_SIZE);
+  c.top = 0;
+
+  for (size_t i = 0; i < n; i++) {
+    const char* json = docs[i];
+    /* Pull in the next document while this one is parsed, every line of
+       it up to FST_BATCH_PREFETCH_SIZE when its length is known */
+    if (i + 1 < n) {
+      size_t ahead = lens != NULL ? lens[i + 1] : 1;
+      if (ahead > FST_BATCH_PREFETCH_SIZE)
+        ahead = FST_BATCH_PREFETCH_SIZE;
+      for (size_t k = 0; k < ahead; k += FST_CACHE_LINE_SIZE)
+        FST_PREFETCH(docs[i + 1] + k);
+      /* An unaligned document can spill into one more line */
+      if (ahead > 1)
+        FST_PREFETCH(docs[i + 1] + ahead - 1);
+    }
+    if (lens != NULL) {
+      if (lens[i] >= cap) {
+        cap = lens[i] + 1 > FST_PARSE_STACK_INIT_SIZE ? lens[i] + 1 : FST_PARSE_STACK_INIT_SIZE;
+        scratch = (char*)realloc(scratch, cap);
+      }
+      memcpy(scratch, docs[i], lens[i]);
+      scratch[lens[i]] = '\0';
+      json = scratch;
+    }
+
+    fst_batch* mark = c.pool;
+    size_t mark_top = c.pool->top;
+    c.json = json;
+    int ret = fst_parse_root(&c, &out[i]);
+    if (ret == FST_PARSE_OK && lens != NULL && c.json != json + lens[i]) {
+      out[i].type = FST_NULL;
       ret = FST_PARSE_ROOT_NOT_SINGULAR;
     }
+    /* A failed document gives back what it took from the pool */
+    if (ret != FST_PARSE_OK) {
+      while (c.pool != mark) {
+        fst_batch* b = c.pool;
+        c.pool = b->next;
+        free(b);
+      }
+      c.pool->top = mark_top;
+    }
+    if (errs != NULL)
+      errs[i] = ret;
   }
-  assert(c.top == 0);
   free(c.stack);
-  return ret;
+  free(scratch);
+  return c.pool;
+}
+
+/* Release the pool of a batch, fst_free values modified since parsing first */
+FST_API void fst_free_batch(fst_batch* b) {
+  while (b != NULL) {
+    fst_batch* next = b->next;
+    free(b);
+    b = next;
+  }
+}
+
+/* Count '\n' in [p, end), eight bytes at a time, and set `*bol` past
+   the last one (or to `p` if there is none) */
+static size_t fst_count_newlines(const char* p, const char* end, const char** bol) {
+  const uint64_t ones = 0x0101010101010101ull, low7 = 0x7F7F7F7F7F7F7F7Full;
+  const char* last = NULL; /* last word holding a newline */
+  size_t n = 0;
+  *bol = p;
+  for (; end - p >= 8; p += 8) {
+    uint64_t x;
+    memcpy(&x, p, 8);
+    x ^= ones * '\n';
+    /* High bit set exactly in the zero bytes, i.e. the newlines */
+    x = ~(((x & low7) + low7) | x | low7);
+    if (x != 0) {
+      n += (size_t)(((x >> 7) * ones) >> 56);
+      last = p;
+    }
+  }
+  if (last != NULL)
+    for (const char* q = last + 8; q > last; q--)
+      if (q[-1] == '\n') {
+        *bol = q;
+        break;
+      }
+  for (; p < end; p++)
+    if (*p == '\n') {
+      n++;
+      *bol = p + 1;
+    }
+  return n;
+}
+
+/* Fill the 1-based line and column of `r->offset` by rescanning `json`,
+   kept off the parse path so that success costs nothing */
+FST_API void fst_locate_error(fst_parse_result* r, const char* json) {
+  const char* end;
+  const char* bol;
+  assert(r != NULL && json != NULL);
+  end = json + r->offset;
+  r->line = fst_count_newlines(json, end, &bol) + 1;
+  r->column = (size_t)(end - bol) + 1;
+}
+
+#ifndef FST_NO_WRITER
+#ifndef FST_NO_FD_WRITER
+/* Write both chunks to `w->fd` in one writev */
+static int fst_writer_output_fd(fst_writer* w, const char* s1, size_t n1, const char* s2, size_t n2) {
+  struct iovec iov[2], *p = iov;
+  int n = 2;
+  iov[0].iov_base = (void*)s1;
+  iov[0].iov_len = n1;
+  iov[1].iov_base = (void*)s2;
+  iov[1].iov_len = n2;
+  while (n > 0) {
+    ssize_t ret = writev(w->fd, p, n);
+    if (ret < 0) {
+      if (errno == EINTR) continue;
+      return w->err = FST_WRITE_IO_ERROR;
+    }
+    /* Skip what was written, resume on a partial write */
+    size_t done = (size_t)ret;
+    while (n > 0 && done >= p->iov_len) {
+      done -= p->iov_len;
+      p++;
+      n--;
+    }
+    if (n > 0) {
+      p->iov_base = (char*)p->iov_base + done;
+      p->iov_len -= done;
+    }
+  }
+  return FST_WRITE_OK;
+}
+#endif
+
+/* Write the staged `s1` and then `s2` straight to the sink */
+static int fst_writer_output(fst_writer* w, const char* s1, size_t n1, const char* s2, size_t n2) {
+#ifndef FST_NO_FD_WRITER
+  if (w->func == NULL)
+    return fst_writer_output_fd(w, s1, n1, s2, n2);
+#endif
+  if ((n1 > 0 && w->func(w->ud, s1, n1) != 0) || (n2 > 0 && w->func(w->ud, s2, n2) != 0))
+    return w->err = FST_WRITE_IO_ERROR;
+  return FST_WRITE_OK;
+}
+
+static void fst_writer_init(fst_writer* w, char* buf, size_t size) {
+  assert(w != NULL && buf != NULL && size > 0);
+  w->buf = buf;
+  w->size = size;
+  w->top = 0;
+  w->fd = -1;
+  w->func = NULL;
+  w->ud = NULL;
+  w->sep = 0;
+  w->err = FST_WRITE_OK;
+}
+
+#ifndef FST_NO_FD_WRITER
+FST_API void fst_writer_init_fd(fst_writer* w, int fd, char* buf, size_t size) {
+  fst_writer_init(w, buf, size);
+  w->fd = fd;
+}
+#endif
+
+FST_API void fst_writer_init_func(fst_writer* w, fst_write_func func, void* ud, char* buf, size_t size) {
+  assert(func != NULL);
+  fst_writer_init(w, buf, size);
+  w->func = func;
+  w->ud = ud;
+}
+
+FST_API int fst_writer_flush(fst_writer* w) {
+  size_t top;
+  assert(w != NULL);
+  if (w->err != FST_WRITE_OK || w->top == 0)
+    return w->err;
+  top = w->top;
+  w->top = 0;
+  return fst_writer_output(w, w->buf, top, NULL, 0);
 }
 
-fst_type fst_get_type(const fst_value* v) {
+/* Stage `len` bytes, a run larger than the buffer goes out
+   together with the staged bytes in one vectored write */
+static void fst_writer_puts(fst_writer* w, const char* s, size_t len) {
+  if (w->err != FST_WRITE_OK)
+    return;
+  if (w->top + len <= w->size) {
+    memcpy(w->buf + w->top, s, len);
+    w->top += len;
+  } else if (len >= w->size) {
+    size_t top = w->top;
+    w->top = 0;
+    fst_writer_output(w, w->buf, top, s, len);
+  } else if (fst_writer_flush(w) == FST_WRITE_OK) {
+    memcpy(w->buf, s, len);
+    w->top = len;
+  }
+}
+
+static void fst_writer_putc(fst_writer* w, char ch) {
+  if (w->err != FST_WRITE_OK || (w->top == w->size && fst_writer_flush(w) != FST_WRITE_OK))
+    return;
+  w->buf[w->top++] = ch;
+}
+
+/* Emit the comma owed by the previous sibling */
+static void fst_writer_sep(fst_writer* w) {
+  if (w->sep)
+    fst_writer_putc(w, ',');
+}
+
+static void fst_writer_string_raw(fst_writer* w, const char* s, size_t len) {
+  static const char hex_digits[] = "0123456789ABCDEF";
+  size_t head = 0;
+  fst_writer_putc(w, '"');
+  for (size_t i = 0; i < len; i++) {
+    unsigned char ch = (unsigned char)s[i];
+    char esc;
+    switch (ch) {
+      case '\"': esc = '\"'; break;
+      case '\\': esc = '\\'; break;
+      case '\b': esc = 'b'; break;
+      case '\f': esc = 'f'; break;
+      case '\n': esc = 'n'; break;
+      case '\r': esc = 'r'; break;
+      case '\t': esc = 't'; break;
+      default:
+        if (ch >= 0x20)
+          continue;
+        esc = 'u';
+    }
+    /* Unescaped run before `i` is copied as a whole */
+    fst_writer_puts(w, s + head, i - head);
+    head = i + 1;
+    fst_writer_putc(w, '\\');
+    fst_writer_putc(w, esc);
+    if (esc == 'u') {
+      fst_writer_puts(w, "00", 2);
+      fst_writer_putc(w, hex_digits[ch >> 4]);
+      fst_writer_putc(w, hex_digits[ch & 15]);
+    }
+  }
+  fst_writer_puts(w, s + head, len - head);
+  fst_writer_putc(w, '"');
+}
+
+FST_API int fst_write_null(fst_writer* w) {
+  fst_writer_sep(w);
+  fst_writer_puts(w, "null", 4);
+  w->sep = 1;
+  return w->err;
+}
+
+FST_API int fst_write_boolean(fst_writer* w, int b) {
+  fst_writer_sep(w);
+  if (b) fst_writer_puts(w, "true", 4);
+  else fst_writer_puts(w, "false", 5);
+  w->sep = 1;
+  return w->err;
+}
+
+/* JSON has no nan or inf, refuse them rather than write invalid text */
+FST_API int fst_write_number(fst_writer* w, double n) {
+  char buffer[32];
+  if (!isfinite(n)) {
+    if (w->err == FST_WRITE_OK)
+      w->err = FST_WRITE_INVALID_NUMBER;
+    return w->err;
+  }
+  fst_writer_sep(w);
+  fst_writer_puts(w, buffer, sprintf(buffer, "%.17g", n));
+  w->sep = 1;
+  return w->err;
+}
+
+FST_API int fst_write_string(fst_writer* w, const char* s, size_t len) {
+  assert(s != NULL || len == 0);
+  fst_writer_sep(w);
+  fst_writer_string_raw(w, s, len);
+  w->sep = 1;
+  return w->err;
+}
+
+/* Member key, the next event is its value */
+FST_API int fst_write_key(fst_writer* w, const char* k, size_t klen) {
+  assert(k != NULL || klen == 0);
+  fst_writer_sep(w);
+  fst_writer_string_raw(w, k, klen);
+  fst_writer_putc(w, ':');
+  w->sep = 0;
+  return w->err;
+}
+
+FST_API int fst_write_begin_array(fst_writer* w) {
+  fst_writer_sep(w);
+  fst_writer_putc(w, '[');
+  w->sep = 0;
+  return w->err;
+}
+
+FST_API int fst_write_end_array(fst_writer* w) {
+  fst_writer_putc(w, ']');
+  w->sep = 1;
+  return w->err;
+}
+
+FST_API int fst_write_begin_object(fst_writer* w) {
+  fst_writer_sep(w);
+  fst_writer_putc(w, '{');
+  w->sep = 0;
+  return w->err;
+}
+
+FST_API int fst_write_end_object(fst_writer* w) {
+  fst_writer_putc(w, '}');
+  w->sep = 1;
+  return w->err;
+}
+
+FST_API int fst_write_value(fst_writer* w, const fst_value* v) {
+  assert(w != NULL && v != NULL);
+  switch (v->type) {
+    case FST_NULL: return fst_write_null(w);
+    case FST_FALSE: return fst_write_boolean(w, 0);
+    case FST_TRUE: return fst_write_boolean(w, 1);
+    case FST_NUMBER: return fst_write_number(w, v->u.n);
+    case FST_STRING: return fst_write_string(w, v->u.s.s, v->u.s.len);
+    case FST_ARRAY:
+      fst_write_begin_array(w);
+      for (size_t i = 0; i < v->u.a.size && w->err == FST_WRITE_OK; i++)
+        fst_write_value(w, &v->u.a.e[i]);
+      return fst_write_end_array(w);
+    case FST_OBJ:
+      fst_write_begin_object(w);
+      for (size_t i = 0; i < v->u.o.size && w->err == FST_WRITE_OK; i++) {
+        fst_write_key(w, v->u.o.m[i].k, v->u.o.m[i].klen);
+        fst_write_value(w, &v->u.o.m[i].v);
+      }
+      return fst_write_end_object(w);
+    default: assert(0 && "invalid type");
+  }
+  return w->err;
+}
+
+/* Sink of fst_stringify, append to the context stack */
+static int fst_stringify_sink(void* ud, const char* s, size_t len) {
+  memcpy(fst_context_push((fst_context*)ud, len), s, len);
+  return 0;
+}
+
+/* Return a malloc'd, NUL-terminated text of `v`,
+   or NULL if `v` holds a non-finite number */
+FST_API char* fst_stringify(const fst_value* v, size_t* length) {
+  fst_context c;
+  fst_writer w;
+  char buf[FST_STRINGIFY_BUFFER_SIZE];
+  assert(v != NULL);
+  c.stack = NULL;
+  c.size = c.top = 0;
+  c.pool = NULL;
+  fst_writer_init_func(&w, fst_stringify_sink, &c, buf, sizeof(buf));
+  fst_write_value(&w, v);
+  if (fst_writer_flush(&w) != FST_WRITE_OK) {
+    free(c.stack);
+    return NULL;
+  }
+  if (length)
+    *length = c.top;
+  FST_PUTC(&c, '\0');
+  return c.stack;
+}
+
+#endif /* FST_NO_WRITER */
+
+FST_API fst_type fst_get_type(const fst_value* v) {
   assert(v != NULL);
   return v->type;
-}
\ No newline at end of file
+}
+
+/* Keep the helpers out of files that include this one (FST_HEADER_ONLY) */
+#undef FST_EXPECT
+#undef FST_ISDIGIT
+#undef FST_ISDIGIT1TO9
+#undef FST_PUTC
+#undef FST_STRING_ERR
+#undef FST_NUMBER_ERR
+#undef FST_PREFETCH
+#undef FST_BATCH_HEADER
+
+#endif
@@ -10,6 +10,26 @@
 
 #include <stddef.h>
 
+/* Define FST_HEADER_ONLY before including this header to compile the
+   whole library into the including translation unit, so that every call
+   can be inlined. FST_NO_WRITER drops the writer and fst_stringify,
+   FST_NO_FD_WRITER drops the file descriptor sink (and <sys/uio.h>). */
+#if defined(__cplusplus) || (defined(__STDC_VERSION__) && __STDC_VERSION__ >= 199901L)
+#define FST_INLINE inline
+#elif defined(__GNUC__)
+#define FST_INLINE __inline__
+#elif defined(_MSC_VER)
+#define FST_INLINE __inline
+#else
+#define FST_INLINE
+#endif
+
+#ifdef FST_HEADER_ONLY
+#define FST_API static FST_INLINE
+#else
+#define FST_API
+#endif
+
 /* JSON file format */
 typedef enum {
   FST_NULL, 
@@ -22,15 +42,17 @@ typedef enum {
 
 typedef struct fst_value fst_value;
 typedef struct fst_member fst_member;
+typedef struct fst_batch fst_batch;
 
 struct fst_value {
   union {
-    struct {fst_member* m; size_t size;} o;
-    struct {fst_value* e; size_t size;} a; /* array */
+    struct {fst_member* m; size_t size, capacity;} o;
+    struct {fst_value* e; size_t size, capacity;} a; /* array */
     struct {char* s; size_t len;} s;
     double n;
   } u;
   fst_type type;
+  unsigned char pooled; /* string or container storage lives in a fst_batch */
 };
 
 struct fst_member {
@@ -56,32 +78,125 @@ enum {
   FST_PARSE_MISS_COMMA_OR_CURLY_BRACKET
 };
 
-#define fst_init(v) do {(v)->type = FST_NULL;} while(0)
-
-void fst_free(fst_value* v);
-
-#define fst_set_null(v) fst_free(v)
-
-int fst_parse(fst_value* v, const char* json);
-
-fst_type fst_get_type(const fst_value* v);
+enum {
+  FST_WRITE_OK = 0,
+  FST_WRITE_IO_ERROR,
+  FST_WRITE_INVALID_NUMBER
+};
 
-int fst_get_boolean(const fst_value* v);
-void fst_set_boolean(fst_value* v, int b);
+/* Outcome of fst_parse_ex, `line` and `column` stay 0
+   until fst_locate_error is called */
+typedef struct {
+  int code;
+  size_t offset; /* byte offset of the failure, or of the end on success */
+  size_t line, column;
+} fst_parse_result;
+
+#define FST_KEY_NOT_EXIST ((size_t)-1)
+
+/* Output sink of a writer, return 0 on success */
+typedef int (*fst_write_func)(void* ud, const char* s, size_t len);
+
+/* Streaming writer, output is staged in the caller-owned `buf`
+   and flushed to `fd` or `func` whenever it fills up */
+typedef struct {
+  char* buf;
+  size_t size, top;
+  int fd;
+  fst_write_func func;
+  void* ud;
+  int sep; /* next value needs a leading comma */
+  int err;
+} fst_writer;
 
-double fst_get_number(const fst_value* v);
-void fst_set_number(fst_value* v, double n);
+#define fst_init(v) do {(v)->type = FST_NULL;} while(0)
 
-const char* fst_get_string(const fst_value* v);
-size_t fst_get_string_len(const fst_value* v);
-void fst_set_string(fst_value* v, const char* s, size_t len);
+FST_API void fst_free(fst_value* v);
 
-size_t fst_get_array_size(const fst_value* v);
-fst_value* fst_get_array_elem(const fst_value* v, size_t index);
+#define fst_set_null(v) fst_free(v)
 
-size_t fst_get_object_size(const fst_value* v);
-const char* fst_get_object_key(const fst_value* v, size_t index);
-size_t fst_get_object_key_length(const fst_value* v, size_t index);
-fst_value* fst_get_object_value(const fst_value* v, size_t index);
+FST_API void fst_copy(fst_value* dst, const fst_value* src);
+FST_API int fst_is_equal(const fst_value* lhs, const fst_value* rhs);
+
+FST_API int fst_parse(fst_value* v, const char* json);
+FST_API int fst_parse_ex(fst_value* v, const char* json, fst_parse_result* r);
+FST_API void fst_locate_error(fst_parse_result* r, const char* json);
+
+/* Batch values may be modified like any other, what they allocate after
+   parsing is released by fst_free, which must precede fst_free_batch */
+FST_API fst_batch* fst_parse_batch(const char* const* docs, const size_t* lens, size_t n, fst_value* out, int* errs);
+FST_API void fst_free_batch(fst_batch* b);
+
+#ifndef FST_NO_WRITER
+FST_API char* fst_stringify(const fst_value* v, size_t* length);
+
+#ifndef FST_NO_FD_WRITER
+FST_API void fst_writer_init_fd(fst_writer* w, int fd, char* buf, size_t size);
+#endif
+FST_API void fst_writer_init_func(fst_writer* w, fst_write_func func, void* ud, char* buf, size_t size);
+FST_API int fst_writer_flush(fst_writer* w);
+
+FST_API int fst_write_value(fst_writer* w, const fst_value* v);
+FST_API int fst_write_null(fst_writer* w);
+FST_API int fst_write_boolean(fst_writer* w, int b);
+FST_API int fst_write_number(fst_writer* w, double n);
+FST_API int fst_write_string(fst_writer* w, const char* s, size_t len);
+FST_API int fst_write_key(fst_writer* w, const char* k, size_t klen);
+FST_API int fst_write_begin_array(fst_writer* w);
+FST_API int fst_write_end_array(fst_writer* w);
+FST_API int fst_write_begin_object(fst_writer* w);
+FST_API int fst_write_end_object(fst_writer* w);
+#endif
+
+FST_API fst_type fst_get_type(const fst_value* v);
+
+FST_API int fst_get_boolean(const fst_value* v);
+FST_API void fst_set_boolean(fst_value* v, int b);
+
+FST_API double fst_get_number(const fst_value* v);
+FST_API void fst_set_number(fst_value* v, double n);
+
+FST_API const char* fst_get_string(const fst_value* v);
+FST_API size_t fst_get_string_len(const fst_value* v);
+FST_API void fst_set_string(fst_value* v, const char* s, size_t len);
+
+FST_API void fst_set_array(fst_value* v, size_t capacity);
+FST_API size_t fst_get_array_size(const fst_value* v);
+FST_API size_t fst_get_array_capacity(const fst_value* v);
+FST_API fst_value* fst_get_array_elem(const fst_value* v, size_t index);
+FST_API fst_value* fst_pushback_array_elem(fst_value* v);
+FST_API fst_value* fst_insert_array_elem(fst_value* v, size_t index);
+
+FST_API void fst_set_object(fst_value* v, size_t capacity);
+FST_API size_t fst_get_object_size(const fst_value* v);
+FST_API size_t fst_get_object_capacity(const fst_value* v);
+FST_API const char* fst_get_object_key(const fst_value* v, size_t index);
+FST_API size_t fst_get_object_key_length(const fst_value* v, size_t index);
+FST_API fst_value* fst_get_object_value(const fst_value* v, size_t index);
+FST_API size_t fst_find_object_index(const fst_value* v, const char* key, size_t klen);
+FST_API fst_value* fst_find_object_value(const fst_value* v, const char* key, size_t klen);
+FST_API fst_value* fst_set_object_value(fst_value* v, const char* key, size_t klen);
+FST_API void fst_remove_object_value(fst_value* v, size_t index);
+
+/* Array or object container capacity */
+FST_API void fst_reserve(fst_value* v, size_t capacity);
+FST_API void fst_shrink(fst_value* v);
+
+/* Unchecked accessors, the caller guarantees the type and index */
+static FST_INLINE fst_type fst_get_type_unchecked(const fst_value* v) { return v->type; }
+static FST_INLINE int fst_get_boolean_unchecked(const fst_value* v) { return v->type == FST_TRUE; }
+static FST_INLINE double fst_get_number_unchecked(const fst_value* v) { return v->u.n; }
+static FST_INLINE const char* fst_get_string_unchecked(const fst_value* v) { return v->u.s.s; }
+static FST_INLINE size_t fst_get_string_len_unchecked(const fst_value* v) { return v->u.s.len; }
+static FST_INLINE size_t fst_get_array_size_unchecked(const fst_value* v) { return v->u.a.size; }
+static FST_INLINE fst_value* fst_get_array_elem_unchecked(const fst_value* v, size_t index) { return &v->u.a.e[index]; }
+static FST_INLINE size_t fst_get_object_size_unchecked(const fst_value* v) { return v->u.o.size; }
+static FST_INLINE const char* fst_get_object_key_unchecked(const fst_value* v, size_t index) { return v->u.o.m[index].k; }
+static FST_INLINE size_t fst_get_object_key_length_unchecked(const fst_value* v, size_t index) { return v->u.o.m[index].klen; }
+static FST_INLINE fst_value* fst_get_object_value_unchecked(const fst_value* v, size_t index) { return &v->u.o.m[index].v; }
+
+#ifdef FST_HEADER_ONLY
+#include "fstjson.c"
+#endif
 
 #endif
\ No newline at end of file
@@ -0,0 +1,36 @@
+/*
+ * @Author: HanwGeek
+ * @Github: https://github.com/HanwGeek
+ * @Description: Shared helpers of the fuzz targets
+ * @Date: 2026-10-19 10:12:40
+ * @Last Modified: 2026-10-19 10:12:40
+ */
+#ifndef FSTJSON_FUZZ_H_
+#define FSTJSON_FUZZ_H_
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Abort so that libFuzzer/AFL++ record the input as a crash */
+#define FUZZ_CHECK(cond)\
+  do {\
+    if (!(cond)) {\
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);\
+      abort();\
+    }\
+  } while(0)
+
+/* fst_parse takes a NUL-terminated text, fuzz input is not */
+static inline char* fuzz_dup(const uint8_t* data, size_t size) {
+  char* json = (char*)malloc(size + 1);
+  memcpy(json, data, size);
+  json[size] = '\0';
+  return json;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+#endif
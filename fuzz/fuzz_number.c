@@ -0,0 +1,75 @@
+/*
+ * @Author: HanwGeek
+ * @Github: https://github.com/HanwGeek
+ * @Description: Fuzz target, number decoding against strtod
+ * @Date: 2026-10-19 10:12:40
+ * @Last Modified: 2026-10-19 10:12:40
+ */
+#include "fuzz.h"
+#include "../fstjson.h"
+
+/* Reference grammar: number = [ "-" ] int [ frac ] [ exp ] */
+static int fuzz_is_number(const char* p) {
+#define DIGIT(ch) ((ch) >= '0' && (ch) <= '9')
+  if (*p == '-') p++;
+  if (*p == '0') p++;
+  else if (*p >= '1' && *p <= '9') while (DIGIT(*p)) p++;
+  else return 0;
+  if (*p == '.') {
+    if (!DIGIT(p[1])) return 0;
+    for (p++; DIGIT(*p); p++);
+  }
+  if (*p == 'e' || *p == 'E') {
+    p++;
+    if (*p == '+' || *p == '-') p++;
+    if (!DIGIT(*p)) return 0;
+    while (DIGIT(*p)) p++;
+  }
+  return *p == '\0';
+#undef DIGIT
+}
+
+#define ISWS(ch) ((ch) == ' ' || (ch) == '\t' || (ch) == '\n' || (ch) == '\r')
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  char* json = fuzz_dup(data, size);
+  char* trim = json;
+  fst_value v, again;
+  char buffer[32];
+
+  fst_init(&v);
+  int ret = fst_parse(&v, json);
+
+  /* Surrounding whitespace is not part of the number */
+  while (ISWS(*trim)) trim++;
+  for (size_t len = strlen(trim); len > 0 && ISWS(trim[len - 1]); len--)
+    trim[len - 1] = '\0';
+
+  /* The parser must accept exactly the JSON number texts, and
+     decode them bit for bit as strtod does */
+  if (fuzz_is_number(trim)) {
+    double n = strtod(trim, NULL);
+    FUZZ_CHECK(ret == FST_PARSE_OK || ret == FST_PARSE_NUMBER_TOO_BIG);
+    if (ret == FST_PARSE_OK) {
+      FUZZ_CHECK(fst_get_type(&v) == FST_NUMBER);
+      FUZZ_CHECK(memcmp(&n, &v.u.n, sizeof(double)) == 0);
+    }
+  } else if (ret == FST_PARSE_OK)
+    FUZZ_CHECK(fst_get_type(&v) != FST_NUMBER);
+
+  /* %.17g text of a decoded number must parse back to it */
+  if (ret == FST_PARSE_OK && fst_get_type(&v) == FST_NUMBER) {
+    double n = fst_get_number(&v);
+    sprintf(buffer, "%.17g", n);
+    fst_init(&again);
+    if (fuzz_is_number(buffer)) {
+      FUZZ_CHECK(fst_parse(&again, buffer) == FST_PARSE_OK);
+      FUZZ_CHECK(memcmp(&n, &again.u.n, sizeof(double)) == 0);
+    }
+    fst_free(&again);
+  }
+
+  fst_free(&v);
+  free(json);
+  return 0;
+}
@@ -0,0 +1,50 @@
+/*
+ * @Author: HanwGeek
+ * @Github: https://github.com/HanwGeek
+ * @Description: Fuzz target, parse -> free
+ * @Date: 2026-10-19 10:12:40
+ * @Last Modified: 2026-10-19 10:12:40
+ */
+#include "fuzz.h"
+#include "../fstjson.h"
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  char* json = fuzz_dup(data, size);
+  fst_value v;
+  fst_parse_result r;
+
+  fst_init(&v);
+  int ret = fst_parse(&v, json);
+  FUZZ_CHECK(ret != FST_PARSE_OK || fst_get_type(&v) <= FST_OBJ);
+  FUZZ_CHECK(ret == FST_PARSE_OK || fst_get_type(&v) == FST_NULL);
+
+  /* Pooled batch parse of the raw bytes must match, the input is
+     parsed twice so that the second one reuses the shared context */
+  const char* docs[2] = {(const char*)data, (const char*)data};
+  size_t lens[2] = {size, size};
+  fst_value out[2];
+  int errs[2];
+  fst_batch* b = fst_parse_batch(docs, lens, 2, out, errs);
+  for (int i = 0; i < 2; i++) {
+    if (strlen(json) == size)
+      FUZZ_CHECK(errs[i] == ret);
+    else
+      FUZZ_CHECK(errs[i] != FST_PARSE_OK || ret != FST_PARSE_OK);
+    if (errs[i] == FST_PARSE_OK)
+      FUZZ_CHECK(fst_is_equal(&v, &out[i]));
+  }
+  fst_free_batch(b);
+  fst_free(&v);
+
+  /* Extended entry must agree with fst_parse */
+  FUZZ_CHECK(fst_parse_ex(&v, json, &r) == ret && r.code == ret);
+  FUZZ_CHECK(r.offset <= strlen(json));
+  fst_free(&v);
+  if (ret != FST_PARSE_OK) {
+    fst_locate_error(&r, json);
+    FUZZ_CHECK(r.line >= 1 && r.column >= 1 && r.column <= r.offset + 1);
+  }
+
+  free(json);
+  return 0;
+}
@@ -0,0 +1,65 @@
+/*
+ * @Author: HanwGeek
+ * @Github: https://github.com/HanwGeek
+ * @Description: Fuzz target, parse -> copy/stringify/write -> compare
+ * @Date: 2026-10-19 10:12:40
+ * @Last Modified: 2026-10-19 10:12:40
+ */
+#include "fuzz.h"
+#include "../fstjson.h"
+
+typedef struct {
+  char* s;
+  size_t len;
+} fuzz_sink;
+
+static int fuzz_sink_write(void* ud, const char* s, size_t len) {
+  fuzz_sink* k = (fuzz_sink*)ud;
+  k->s = (char*)realloc(k->s, k->len + len);
+  memcpy(k->s + k->len, s, len);
+  k->len += len;
+  return 0;
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  char* json = fuzz_dup(data, size);
+  fst_value v, copy, again;
+  fst_writer w;
+  fuzz_sink k = {NULL, 0};
+  char buf[7];
+  size_t len;
+
+  fst_init(&v);
+  if (fst_parse(&v, json) != FST_PARSE_OK) {
+    free(json);
+    return 0;
+  }
+
+  /* parse -> copy -> compare */
+  fst_init(&copy);
+  fst_copy(&copy, &v);
+  FUZZ_CHECK(fst_is_equal(&v, &copy));
+  FUZZ_CHECK(fst_is_equal(&copy, &v));
+  fst_free(&copy);
+
+  /* parse -> stringify -> parse must give the same tree */
+  char* text = fst_stringify(&v, &len);
+  FUZZ_CHECK(strlen(text) == len);
+  fst_init(&again);
+  FUZZ_CHECK(fst_parse(&again, text) == FST_PARSE_OK);
+  FUZZ_CHECK(fst_is_equal(&v, &again));
+  FUZZ_CHECK(fst_is_equal(&again, &v));
+  fst_free(&again);
+
+  /* Streaming writer with a tiny buffer must match fst_stringify */
+  fst_writer_init_func(&w, fuzz_sink_write, &k, buf, sizeof(buf));
+  FUZZ_CHECK(fst_write_value(&w, &v) == FST_WRITE_OK);
+  FUZZ_CHECK(fst_writer_flush(&w) == FST_WRITE_OK);
+  FUZZ_CHECK(k.len == len && memcmp(k.s, text, len) == 0);
+
+  free(k.s);
+  free(text);
+  fst_free(&v);
+  free(json);
+  return 0;
+}
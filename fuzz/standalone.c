@@ -0,0 +1,38 @@
+/*
+ * @Author: HanwGeek
+ * @Github: https://github.com/HanwGeek
+ * @Description: Offline driver of the fuzz targets, runs each file
+ *               given on the command line (or stdin) through the target
+ * @Date: 2026-10-19 10:12:40
+ * @Last Modified: 2026-10-19 10:12:40
+ */
+#include "fuzz.h"
+
+static int fuzz_run(FILE* fp) {
+  uint8_t* data = NULL;
+  size_t size = 0, cap = 0, n;
+  do {
+    if (size == cap)
+      data = (uint8_t*)realloc(data, cap = cap ? cap * 2 : 4096);
+    n = fread(data + size, 1, cap - size, fp);
+    size += n;
+  } while (n > 0);
+  LLVMFuzzerTestOneInput(data, size);
+  free(data);
+  return 0;
+}
+
+int main(int argc, char** argv) {
+  if (argc < 2)
+    return fuzz_run(stdin);
+  for (int i = 1; i < argc; i++) {
+    FILE* fp = fopen(argv[i], "rb");
+    if (fp == NULL) {
+      fprintf(stderr, "cannot open %s\n", argv[i]);
+      return 1;
+    }
+    fuzz_run(fp);
+    fclose(fp);
+  }
+  return 0;
+}
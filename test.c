@@ -5,6 +5,7 @@
  * @Date: 2020-01-01 21:32:35
  * @Last Modified: 2020-01-03 20:00:58
  */
+#include <math.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -112,6 +113,10 @@ static void test_parse_string() {
     TEST_STRING("Hello", "\"Hello\"");
     TEST_STRING("Hello\nWorld", "\"Hello\\nWorld\"");
     TEST_STRING("\" \\ / \b \f \n \r \t", "\"\\\" \\\\ \\/ \\b \\f \\n \\r \\t\"");
+    TEST_STRING("\x24", "\"\\u0024\"");         /* Dollar sign U+0024 */
+    TEST_STRING("\xE2\x82\xAC", "\"\\u20AC\""); /* Euro sign U+20AC */
+    TEST_STRING("\xF0\x9D\x84\x9E", "\"\\uD834\\uDD1E\"");  /* G clef sign U+1D11E */
+    TEST_STRING("\xF0\x9D\x84\x9E", "\"\\ud834\\udd1e\"");
 }
 
 #define TEST_ERROR(err, json) \
@@ -151,6 +156,11 @@ static void test_parse_root_not_singular() {
   TEST_ERROR(FST_PARSE_ROOT_NOT_SINGULAR, "0x123"); 
 }
 
+static void test_parse_number_too_big() {
+  TEST_ERROR(FST_PARSE_NUMBER_TOO_BIG, "1e309");
+  TEST_ERROR(FST_PARSE_NUMBER_TOO_BIG, "-1e309");
+}
+
 static void test_parse_missing_quotation_mark() {
     TEST_ERROR(FST_PARSE_MISS_QUOTATION_MARK, "\"");
     TEST_ERROR(FST_PARSE_MISS_QUOTATION_MARK, "\"abc");
@@ -207,6 +217,47 @@ static void test_parse_array() {
   fst_free(&v);  
 }
 
+static void test_parse_object() {
+  fst_value v;
+
+  fst_init(&v);
+  EXPECT_EQ_INT(FST_PARSE_OK, fst_parse(&v, " { } "));
+  EXPECT_EQ_INT(FST_OBJ, fst_get_type(&v));
+  EXPECT_EQ_SIZE_T(0, fst_get_object_size(&v));
+  fst_free(&v);
+
+  fst_init(&v);
+  EXPECT_EQ_INT(FST_PARSE_OK, fst_parse(&v,
+    " { "
+    "\"n\" : null , "
+    "\"f\" : false , "
+    "\"t\" : true , "
+    "\"i\" : 123 , "
+    "\"s\" : \"abc\", "
+    "\"a\" : [ 1, 2, 3 ],"
+    "\"o\" : { \"1\" : 1, \"2\" : 2, \"3\" : 3 }"
+    " } "
+  ));
+  EXPECT_EQ_INT(FST_OBJ, fst_get_type(&v));
+  EXPECT_EQ_SIZE_T(7, fst_get_object_size(&v));
+  EXPECT_EQ_STRING("n", fst_get_object_key(&v, 0), fst_get_object_key_length(&v, 0));
+  EXPECT_EQ_INT(FST_NULL, fst_get_type(fst_get_object_value(&v, 0)));
+  EXPECT_EQ_STRING("i", fst_get_object_key(&v, 3), fst_get_object_key_length(&v, 3));
+  EXPECT_EQ_DOUBLE(123.0, fst_get_number(fst_get_object_value(&v, 3)));
+  EXPECT_EQ_STRING("a", fst_get_object_key(&v, 5), fst_get_object_key_length(&v, 5));
+  EXPECT_EQ_SIZE_T(3, fst_get_array_size(fst_get_object_value(&v, 5)));
+  EXPECT_EQ_STRING("o", fst_get_object_key(&v, 6), fst_get_object_key_length(&v, 6));
+  fst_value* o = fst_get_object_value(&v, 6);
+  EXPECT_EQ_INT(FST_OBJ, fst_get_type(o));
+  for (size_t i = 0; i < 3; i++) {
+    fst_value* ov = fst_get_object_value(o, i);
+    EXPECT_TRUE('1' + i == fst_get_object_key(o, i)[0]);
+    EXPECT_EQ_SIZE_T(1, fst_get_object_key_length(o, i));
+    EXPECT_EQ_DOUBLE(i + 1.0, fst_get_number(ov));
+  }
+  fst_free(&v);
+}
+
 static void test_parse_miss_key() {
     TEST_ERROR(FST_PARSE_MISS_KEY, "{:1,");
     TEST_ERROR(FST_PARSE_MISS_KEY, "{1:1,");
@@ -230,6 +281,331 @@ static void test_parse_miss_comma_or_curly_bracket() {
     TEST_ERROR(FST_PARSE_MISS_COMMA_OR_CURLY_BRACKET, "{\"a\":{}");
 }
 
+#define TEST_ERROR_POS(err, off, ln, col, json)\
+  do {\
+    fst_value v;\
+    fst_parse_result r;\
+    fst_init(&v);\
+    EXPECT_EQ_INT(err, fst_parse_ex(&v, json, &r));\
+    EXPECT_EQ_INT(err, r.code);\
+    EXPECT_EQ_SIZE_T(off, r.offset);\
+    EXPECT_EQ_SIZE_T(0, r.line);\
+    fst_locate_error(&r, json);\
+    EXPECT_EQ_SIZE_T(ln, r.line);\
+    EXPECT_EQ_SIZE_T(col, r.column);\
+    fst_free(&v);\
+  } while(0)
+
+static void test_parse_error_position() {
+  TEST_ERROR_POS(FST_PARSE_OK, 4, 1, 5, "null");
+  TEST_ERROR_POS(FST_PARSE_EXPECT_VALUE, 2, 2, 2, "\n ");
+  TEST_ERROR_POS(FST_PARSE_INVALID_VALUE, 3, 1, 4, "nul");
+  TEST_ERROR_POS(FST_PARSE_INVALID_VALUE, 2, 1, 3, "1.");
+  TEST_ERROR_POS(FST_PARSE_ROOT_NOT_SINGULAR, 5, 1, 6, "null x");
+  TEST_ERROR_POS(FST_PARSE_MISS_QUOTATION_MARK, 4, 1, 5, "\"abc");
+  TEST_ERROR_POS(FST_PARSE_INVALID_STRING_ESCAPE, 2, 1, 3, "\"a\\v\"");
+  TEST_ERROR_POS(FST_PARSE_INVALID_STRING_CHAR, 2, 1, 3, "\"a\x01\"");
+  TEST_ERROR_POS(FST_PARSE_INVALID_UNICODE_HEX, 1, 1, 2, "\"\\u00G0\"");
+  TEST_ERROR_POS(FST_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, 6, 3, 1, "[1,\n2\n}");
+  TEST_ERROR_POS(FST_PARSE_MISS_COLON, 12, 2, 5, "{\"a\":1,\n\"b\" 2}");
+  /* Long lines cross the word-at-a-time newline counter */
+  TEST_ERROR_POS(FST_PARSE_INVALID_VALUE, 54, 11, 7, "[\n1,\n2,\n3,\n4,\n5,\n6,\n7,\n8,\n\"abcdefghijklmnopqr\",\n   9, x]");
+  /* Last newline in the scalar tail, and a minified single line */
+  TEST_ERROR_POS(FST_PARSE_INVALID_VALUE, 13, 3, 1, "[1,2,3,4,\n5,\nx]");
+  TEST_ERROR_POS(FST_PARSE_INVALID_VALUE, 40, 1, 41, "[1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16,x]");
+}
+
+#ifndef FST_NO_WRITER
+#define TEST_ROUNDTRIP(json)\
+  do {\
+    fst_value v;\
+    char* json2;\
+    size_t length;\
+    fst_init(&v);\
+    EXPECT_EQ_INT(FST_PARSE_OK, fst_parse(&v, json));\
+    json2 = fst_stringify(&v, &length);\
+    EXPECT_EQ_STRING(json, json2, length);\
+    fst_free(&v);\
+    free(json2);\
+  } while(0)
+
+static void test_stringify() {
+  TEST_ROUNDTRIP("null");
+  TEST_ROUNDTRIP("false");
+  TEST_ROUNDTRIP("true");
+  TEST_ROUNDTRIP("0");
+  TEST_ROUNDTRIP("-0");
+  TEST_ROUNDTRIP("1.5");
+  TEST_ROUNDTRIP("1.0000000000000002");
+  TEST_ROUNDTRIP("4.9406564584124654e-324");
+  TEST_ROUNDTRIP("1.7976931348623157e+308");
+  TEST_ROUNDTRIP("\"\"");
+  TEST_ROUNDTRIP("\"Hello\"");
+  TEST_ROUNDTRIP("\"\\\" \\\\ / \\b \\f \\n \\r \\t\"");
+  TEST_ROUNDTRIP("\"\\u0001\\u001F\"");
+  TEST_ROUNDTRIP("[]");
+  TEST_ROUNDTRIP("[null,false,true,123,\"abc\",[1,2,3]]");
+  TEST_ROUNDTRIP("{}");
+  TEST_ROUNDTRIP("{\"n\":null,\"f\":false,\"t\":true,\"i\":123,\"s\":\"abc\",\"a\":[1,2,3],\"o\":{\"1\":1,\"2\":2,\"3\":3}}");
+}
+
+typedef struct {
+  char s[256];
+  size_t len, calls;
+} test_sink;
+
+static int test_sink_write(void* ud, const char* s, size_t len) {
+  test_sink* k = (test_sink*)ud;
+  if (k->len + len > sizeof(k->s))
+    return -1;
+  memcpy(k->s + k->len, s, len);
+  k->len += len;
+  k->calls++;
+  return 0;
+}
+
+static void test_writer() {
+  static const char json[] = "{\"name\":\"a long string that outruns the buffer\",\"list\":[1,\"\\n\",[],{}],\"ok\":true}";
+  fst_value v;
+  fst_writer w;
+  test_sink k;
+  char buf[8];
+
+  /* Builder events */
+  memset(&k, 0, sizeof(k));
+  fst_writer_init_func(&w, test_sink_write, &k, buf, sizeof(buf));
+  fst_write_begin_object(&w);
+  fst_write_key(&w, "name", 4);
+  fst_write_string(&w, "a long string that outruns the buffer", 37);
+  fst_write_key(&w, "list", 4);
+  fst_write_begin_array(&w);
+  fst_write_number(&w, 1.0);
+  fst_write_string(&w, "\n", 1);
+  fst_write_begin_array(&w);
+  fst_write_end_array(&w);
+  fst_write_begin_object(&w);
+  fst_write_end_object(&w);
+  fst_write_end_array(&w);
+  fst_write_key(&w, "ok", 2);
+  fst_write_boolean(&w, 1);
+  fst_write_end_object(&w);
+  EXPECT_EQ_INT(FST_WRITE_OK, fst_writer_flush(&w));
+  EXPECT_EQ_STRING(json, k.s, k.len);
+  EXPECT_TRUE(k.calls > 1);
+
+  /* Value tree */
+  fst_init(&v);
+  EXPECT_EQ_INT(FST_PARSE_OK, fst_parse(&v, json));
+  memset(&k, 0, sizeof(k));
+  fst_writer_init_func(&w, test_sink_write, &k, buf, sizeof(buf));
+  EXPECT_EQ_INT(FST_WRITE_OK, fst_write_value(&w, &v));
+  EXPECT_EQ_INT(FST_WRITE_OK, fst_writer_flush(&w));
+  EXPECT_EQ_STRING(json, k.s, k.len);
+
+  /* Sink failure is sticky */
+  memset(&k, 0, sizeof(k));
+  k.len = sizeof(k.s);
+  fst_writer_init_func(&w, test_sink_write, &k, buf, sizeof(buf));
+  fst_write_value(&w, &v);
+  EXPECT_EQ_INT(FST_WRITE_IO_ERROR, fst_writer_flush(&w));
+  EXPECT_EQ_INT(FST_WRITE_IO_ERROR, fst_write_null(&w));
+
+  /* Non-finite numbers have no JSON text, the error is sticky too */
+  memset(&k, 0, sizeof(k));
+  fst_writer_init_func(&w, test_sink_write, &k, buf, sizeof(buf));
+  fst_write_begin_array(&w);
+  EXPECT_EQ_INT(FST_WRITE_INVALID_NUMBER, fst_write_number(&w, HUGE_VAL));
+  EXPECT_EQ_INT(FST_WRITE_INVALID_NUMBER, fst_write_number(&w, 1.0));
+  EXPECT_EQ_INT(FST_WRITE_INVALID_NUMBER, fst_writer_flush(&w));
+  EXPECT_EQ_SIZE_T(0, k.len);
+  fst_value n;
+  fst_init(&n);
+  fst_set_number(&n, -HUGE_VAL);
+  fst_writer_init_func(&w, test_sink_write, &k, buf, sizeof(buf));
+  EXPECT_EQ_INT(FST_WRITE_INVALID_NUMBER, fst_write_value(&w, &n));
+  fst_set_number(&n, NAN);
+  fst_writer_init_func(&w, test_sink_write, &k, buf, sizeof(buf));
+  EXPECT_EQ_INT(FST_WRITE_INVALID_NUMBER, fst_write_value(&w, &n));
+  EXPECT_TRUE(fst_stringify(&n, NULL) == NULL);
+
+#ifndef FST_NO_FD_WRITER
+  /* File descriptor */
+  FILE* fp = tmpfile();
+  if (fp != NULL) {
+    fst_writer_init_fd(&w, fileno(fp), buf, sizeof(buf));
+    EXPECT_EQ_INT(FST_WRITE_OK, fst_write_value(&w, &v));
+    EXPECT_EQ_INT(FST_WRITE_OK, fst_writer_flush(&w));
+    rewind(fp);
+    k.len = fread(k.s, 1, sizeof(k.s), fp);
+    EXPECT_EQ_STRING(json, k.s, k.len);
+    fclose(fp);
+  }
+#endif
+  fst_free(&v);
+}
+
+#endif
+
+#define TEST_EQUAL(json1, json2, equality) \
+  do {\
+    fst_value v1, v2;\
+    fst_init(&v1);\
+    fst_init(&v2);\
+    EXPECT_EQ_INT(FST_PARSE_OK, fst_parse(&v1, json1));\
+    EXPECT_EQ_INT(FST_PARSE_OK, fst_parse(&v2, json2));\
+    EXPECT_EQ_INT(equality, fst_is_equal(&v1, &v2));\
+    fst_free(&v1);\
+    fst_free(&v2);\
+  } while(0)
+
+static void test_equal() {
+  TEST_EQUAL("true", "true", 1);
+  TEST_EQUAL("true", "false", 0);
+  TEST_EQUAL("123", "123", 1);
+  TEST_EQUAL("123", "456", 0);
+  TEST_EQUAL("\"abc\"", "\"abc\"", 1);
+  TEST_EQUAL("\"abc\"", "\"abcd\"", 0);
+  TEST_EQUAL("[]", "[]", 1);
+  TEST_EQUAL("[]", "null", 0);
+  TEST_EQUAL("[1,2,3]", "[1,2,3]", 1);
+  TEST_EQUAL("[1,2,3]", "[1,2,3,4]", 0);
+  TEST_EQUAL("[[]]", "[[]]", 1);
+  TEST_EQUAL("{\"a\":1,\"b\":2}", "{\"b\":2,\"a\":1}", 1);
+  TEST_EQUAL("{\"a\":1,\"b\":2}", "{\"a\":1,\"b\":3}", 0);
+  TEST_EQUAL("{\"a\":1,\"b\":2}", "{\"a\":1,\"b\":2,\"c\":3}", 0);
+  TEST_EQUAL("{\"a\":{\"b\":{\"c\":{}}}}", "{\"a\":{\"b\":{\"c\":{}}}}", 1);
+  TEST_EQUAL("{\"a\":{\"b\":{\"c\":{}}}}", "{\"a\":{\"b\":{\"c\":[]}}}", 0);
+  /* Duplicate keys compare position by position, in both directions */
+  TEST_EQUAL("{\"a\":1,\"a\":2}", "{\"a\":1,\"a\":2}", 1);
+  TEST_EQUAL("{\"a\":1,\"a\":2}", "{\"a\":2,\"a\":1}", 0);
+  TEST_EQUAL("{\"a\":1,\"a\":1}", "{\"a\":1,\"b\":1}", 0);
+  TEST_EQUAL("{\"a\":1,\"b\":1}", "{\"a\":1,\"a\":1}", 0);
+  TEST_EQUAL("{\"b\":1,\"a\":1}", "{\"a\":1,\"a\":1}", 0);
+}
+
+static void test_copy() {
+  fst_value v1, v2;
+  fst_init(&v1);
+  fst_parse(&v1, "{\"t\":true,\"f\":false,\"n\":null,\"d\":1.5,\"a\":[1,2,3],\"s\":\"abc\"}");
+  fst_init(&v2);
+  fst_set_string(&v2, "old", 3);
+  fst_copy(&v2, &v1);
+  EXPECT_TRUE(fst_is_equal(&v2, &v1));
+  fst_free(&v1);
+  EXPECT_EQ_SIZE_T(6, fst_get_object_size(&v2));
+  fst_free(&v2);
+}
+
+static void test_access_unchecked() {
+  fst_value v;
+  fst_init(&v);
+  EXPECT_EQ_INT(FST_PARSE_OK, fst_parse(&v, "{\"a\":[true,1.5,\"s\"]}"));
+  EXPECT_EQ_INT(FST_OBJ, fst_get_type_unchecked(&v));
+  EXPECT_EQ_SIZE_T(1, fst_get_object_size_unchecked(&v));
+  EXPECT_EQ_STRING("a", fst_get_object_key_unchecked(&v, 0), fst_get_object_key_length_unchecked(&v, 0));
+  fst_value* a = fst_get_object_value_unchecked(&v, 0);
+  EXPECT_EQ_SIZE_T(3, fst_get_array_size_unchecked(a));
+  EXPECT_TRUE(fst_get_boolean_unchecked(fst_get_array_elem_unchecked(a, 0)));
+  EXPECT_EQ_DOUBLE(1.5, fst_get_number_unchecked(fst_get_array_elem_unchecked(a, 1)));
+  EXPECT_EQ_STRING("s", fst_get_string_unchecked(fst_get_array_elem_unchecked(a, 2)), fst_get_string_len_unchecked(fst_get_array_elem_unchecked(a, 2)));
+  fst_free(&v);
+}
+
+static void test_parse_batch() {
+  static const char* docs[] = {
+    "{\"id\":1,\"tags\":[\"a\",\"b\"]}",
+    "[1 2",
+    "  \"str\"  ",
+    "null x",
+    "{\"a\":{\"b\":[true,false,null]}}"
+  };
+  static const char text[] = "[1]\0[2]";
+  const char* with_nul[] = {text, text};
+  size_t lens[] = {3, sizeof(text) - 1};
+  fst_value out[5], v;
+  int errs[5];
+  fst_batch* b;
+
+  b = fst_parse_batch(docs, NULL, 5, out, errs);
+  EXPECT_EQ_INT(FST_PARSE_OK, errs[0]);
+  EXPECT_EQ_INT(FST_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, errs[1]);
+  EXPECT_EQ_INT(FST_PARSE_OK, errs[2]);
+  EXPECT_EQ_INT(FST_PARSE_ROOT_NOT_SINGULAR, errs[3]);
+  EXPECT_EQ_INT(FST_PARSE_OK, errs[4]);
+  EXPECT_EQ_INT(FST_NULL, fst_get_type(&out[1]));
+  EXPECT_EQ_INT(FST_NULL, fst_get_type(&out[3]));
+  EXPECT_EQ_STRING("str", fst_get_string(&out[2]), fst_get_string_len(&out[2]));
+  for (size_t i = 0; i < 5; i += 4) {
+    fst_init(&v);
+    EXPECT_EQ_INT(FST_PARSE_OK, fst_parse(&v, docs[i]));
+    EXPECT_TRUE(fst_is_equal(&v, &out[i]));
+    fst_free(&v);
+  }
+  fst_free_batch(b);
+
+  /* With lengths, documents need not be NUL-terminated */
+  b = fst_parse_batch(with_nul, lens, 2, out, errs);
+  EXPECT_EQ_INT(FST_PARSE_OK, errs[0]);
+  EXPECT_EQ_SIZE_T(1, fst_get_array_size(&out[0]));
+  EXPECT_EQ_INT(FST_PARSE_ROOT_NOT_SINGULAR, errs[1]);
+  fst_free_batch(b);
+}
+
+static void test_parse_batch_modify() {
+  static const char* docs[] = {"[1,2]", "{\"a\":\"x\",\"b\":[true]}", "\"s\""};
+  fst_value out[3], v;
+  fst_batch* b;
+
+  b = fst_parse_batch(docs, NULL, 3, out, NULL);
+  /* Growing a pooled array moves it to malloc'd storage */
+  for (size_t i = 0; i < 10; i++)
+    fst_set_number(fst_pushback_array_elem(&out[0]), (double)i);
+  fst_set_string(fst_insert_array_elem(&out[0], 0), "first", 5);
+  EXPECT_EQ_SIZE_T(13, fst_get_array_size(&out[0]));
+  EXPECT_EQ_DOUBLE(2.0, fst_get_number(fst_get_array_elem(&out[0], 2)));
+  EXPECT_EQ_DOUBLE(9.0, fst_get_number(fst_get_array_elem(&out[0], 12)));
+
+  /* So do objects, together with their keys */
+  fst_set_boolean(fst_set_object_value(&out[1], "c", 1), 0);
+  fst_remove_object_value(&out[1], fst_find_object_index(&out[1], "a", 1));
+  fst_set_number(fst_pushback_array_elem(fst_find_object_value(&out[1], "b", 1)), 1.0);
+  fst_init(&v);
+  EXPECT_EQ_INT(FST_PARSE_OK, fst_parse(&v, "{\"b\":[true,1],\"c\":false}"));
+  EXPECT_TRUE(fst_is_equal(&v, &out[1]));
+  fst_shrink(&out[1]);
+  EXPECT_EQ_SIZE_T(2, fst_get_object_capacity(&out[1]));
+  EXPECT_TRUE(fst_is_equal(&out[1], &v));
+  fst_free(&v);
+
+  /* Replacing a pooled string, then freeing every value, must not free pool memory */
+  fst_set_string(&out[2], "t", 1);
+  EXPECT_EQ_STRING("t", fst_get_string(&out[2]), fst_get_string_len(&out[2]));
+  for (size_t i = 0; i < 3; i++)
+    fst_free(&out[i]);
+  fst_free_batch(b);
+}
+
+static void test_parse_batch_grow() {
+  enum { N = 1000 };
+  static const char doc[] = "{\"key\":[\"value\",1,2,3,{\"k\":\"v\"}]}";
+  const char* docs[N];
+  fst_value* out = (fst_value*)malloc(N * sizeof(fst_value));
+  fst_value v;
+  fst_batch* b;
+
+  /* Without lengths the pool starts small and has to chain chunks */
+  for (size_t i = 0; i < N; i++)
+    docs[i] = doc;
+  b = fst_parse_batch(docs, NULL, N, out, NULL);
+  fst_init(&v);
+  EXPECT_EQ_INT(FST_PARSE_OK, fst_parse(&v, doc));
+  EXPECT_TRUE(fst_is_equal(&v, &out[0]));
+  EXPECT_TRUE(fst_is_equal(&v, &out[N - 1]));
+  fst_free(&v);
+  fst_free_batch(b);
+  free(out);
+}
+
 static void test_access_null() {
   fst_value v;
   fst_init(&v);
@@ -269,6 +645,95 @@ static void test_access_string() {
   fst_free(&v);
 }
 
+static void test_access_array() {
+  fst_value a, e;
+  fst_init(&a);
+
+  for (size_t j = 0; j <= 5; j += 5) {
+    fst_set_array(&a, j);
+    EXPECT_EQ_SIZE_T(0, fst_get_array_size(&a));
+    EXPECT_EQ_SIZE_T(j, fst_get_array_capacity(&a));
+    for (size_t i = 0; i < 10; i++)
+      fst_set_number(fst_pushback_array_elem(&a), (double)i);
+    EXPECT_EQ_SIZE_T(10, fst_get_array_size(&a));
+    EXPECT_TRUE(fst_get_array_capacity(&a) >= 10);
+    for (size_t i = 0; i < 10; i++)
+      EXPECT_EQ_DOUBLE((double)i, fst_get_number(fst_get_array_elem(&a, i)));
+  }
+
+  fst_set_string(fst_insert_array_elem(&a, 0), "a", 1);
+  fst_set_number(fst_insert_array_elem(&a, 5), -1.0);
+  fst_set_boolean(fst_insert_array_elem(&a, 12), 1);
+  EXPECT_EQ_SIZE_T(13, fst_get_array_size(&a));
+  EXPECT_EQ_STRING("a", fst_get_string(fst_get_array_elem(&a, 0)), fst_get_string_len(fst_get_array_elem(&a, 0)));
+  EXPECT_EQ_DOUBLE(3.0, fst_get_number(fst_get_array_elem(&a, 4)));
+  EXPECT_EQ_DOUBLE(-1.0, fst_get_number(fst_get_array_elem(&a, 5)));
+  EXPECT_EQ_DOUBLE(4.0, fst_get_number(fst_get_array_elem(&a, 6)));
+  EXPECT_EQ_DOUBLE(9.0, fst_get_number(fst_get_array_elem(&a, 11)));
+  EXPECT_TRUE(fst_get_boolean(fst_get_array_elem(&a, 12)));
+
+  fst_reserve(&a, 100);
+  EXPECT_EQ_SIZE_T(100, fst_get_array_capacity(&a));
+  fst_shrink(&a);
+  EXPECT_EQ_SIZE_T(13, fst_get_array_capacity(&a));
+  EXPECT_EQ_DOUBLE(9.0, fst_get_number(fst_get_array_elem(&a, 11)));
+
+  fst_init(&e);
+  fst_set_array(&e, 0);
+  fst_shrink(&e);
+  EXPECT_EQ_SIZE_T(0, fst_get_array_capacity(&e));
+  fst_free(&e);
+  fst_free(&a);
+}
+
+static void test_access_object() {
+  fst_value o;
+  char key[2] = "a";
+  fst_init(&o);
+
+  for (size_t j = 0; j <= 5; j += 5) {
+    fst_set_object(&o, j);
+    EXPECT_EQ_SIZE_T(0, fst_get_object_size(&o));
+    EXPECT_EQ_SIZE_T(j, fst_get_object_capacity(&o));
+    for (size_t i = 0; i < 10; i++) {
+      key[0] = 'a' + i;
+      fst_set_number(fst_set_object_value(&o, key, 1), (double)i);
+    }
+    EXPECT_EQ_SIZE_T(10, fst_get_object_size(&o));
+    EXPECT_TRUE(fst_get_object_capacity(&o) >= 10);
+    for (size_t i = 0; i < 10; i++) {
+      key[0] = 'a' + i;
+      size_t index = fst_find_object_index(&o, key, 1);
+      EXPECT_EQ_SIZE_T(i, index);
+      EXPECT_EQ_DOUBLE((double)i, fst_get_number(fst_get_object_value(&o, index)));
+    }
+  }
+
+  /* Setting an existing key reuses its member */
+  fst_set_string(fst_set_object_value(&o, "j", 1), "x", 1);
+  EXPECT_EQ_SIZE_T(10, fst_get_object_size(&o));
+  EXPECT_EQ_INT(FST_STRING, fst_get_type(fst_find_object_value(&o, "j", 1)));
+
+  fst_remove_object_value(&o, fst_find_object_index(&o, "a", 1));
+  EXPECT_EQ_SIZE_T(FST_KEY_NOT_EXIST, fst_find_object_index(&o, "a", 1));
+  EXPECT_TRUE(fst_find_object_value(&o, "a", 1) == NULL);
+  EXPECT_EQ_SIZE_T(9, fst_get_object_size(&o));
+  EXPECT_EQ_STRING("b", fst_get_object_key(&o, 0), fst_get_object_key_length(&o, 0));
+
+  fst_remove_object_value(&o, fst_find_object_index(&o, "j", 1));
+  EXPECT_EQ_SIZE_T(8, fst_get_object_size(&o));
+  fst_remove_object_value(&o, fst_find_object_index(&o, "e", 1));
+  EXPECT_EQ_SIZE_T(7, fst_get_object_size(&o));
+  EXPECT_EQ_STRING("f", fst_get_object_key(&o, 3), fst_get_object_key_length(&o, 3));
+  EXPECT_EQ_DOUBLE(5.0, fst_get_number(fst_get_object_value(&o, 3)));
+
+  fst_shrink(&o);
+  EXPECT_EQ_SIZE_T(7, fst_get_object_capacity(&o));
+  fst_reserve(&o, 32);
+  EXPECT_EQ_SIZE_T(32, fst_get_object_capacity(&o));
+  fst_free(&o);
+}
+
 static void test_parse() {
   test_parse_null();
   test_parse_true();
@@ -276,20 +741,36 @@ static void test_parse() {
   test_parse_number();
   test_parse_string();
   test_parse_array();
+  test_parse_object();
   test_parse_expect_value();
   test_parse_invalid_value();
   test_parse_root_not_singular();
+  test_parse_number_too_big();
   test_parse_missing_quotation_mark();
   test_parse_invalid_string_escape();
   test_parse_invalid_string_char();
   test_parse_miss_key();
   test_parse_miss_colon();
   test_parse_miss_comma_or_curly_bracket();
+  test_parse_error_position();
+  test_parse_batch();
+  test_parse_batch_modify();
+  test_parse_batch_grow();
+
+#ifndef FST_NO_WRITER
+  test_stringify();
+  test_writer();
+#endif
+  test_equal();
+  test_copy();
 
   test_access_null();
   test_access_boolean();
   test_access_number();
   test_access_string();
+  test_access_array();
+  test_access_object();
+  test_access_unchecked();
 }
 
 int main() {
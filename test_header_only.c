@@ -0,0 +1,34 @@
+/*
+ * @Author: HanwGeek
+ * @Github: https://github.com/HanwGeek
+ * @Description: Header-only build must not clash with common macro names
+ * @Date: 2026-10-19 18:05:31
+ * @Last Modified: 2026-10-19 18:05:31
+ */
+#include <stdio.h>
+
+/* Names a user or a test harness is likely to define already */
+#define EXPECT(x) (x)
+#define ISDIGIT(x) ((x) >= '0' && (x) <= '9')
+#define PUTC(x) putchar(x)
+#define STRING_ERR 1
+#define NUMBER_ERR 2
+
+#ifndef FST_HEADER_ONLY
+#define FST_HEADER_ONLY
+#endif
+#include "fstjson.h"
+
+int main() {
+  fst_value v;
+  int ret = 0;
+  fst_init(&v);
+  if (!EXPECT(fst_parse(&v, "[\"1\", 2]") == FST_PARSE_OK) || !ISDIGIT(*fst_get_string(fst_get_array_elem(&v, 0))))
+    ret = 1;
+  fst_free(&v);
+  if (STRING_ERR + NUMBER_ERR != 3)
+    ret = 1;
+  PUTC(ret ? 'F' : 'P');
+  PUTC('\n');
+  return ret;
+}